@@ -1,5 +1,5 @@
 #include "Controller.h"
-#include "../Object/Parser.h"
+#include "../Object/MeshAsset.h"
 #include "Model.h"
 
 namespace Core {
@@ -8,89 +8,154 @@ Controller::Controller(Model* model_link) : model_link_(model_link) {
 }
 
 void Controller::AddObject(Scene::Object& object) {
-  model_link_->objects_.push_back(object);
+  model_link_->PublishScene(model_link_->GetScene()->WithObjectAdded(object));
   UpdateAll();
 }
 
 void Controller::AddView(Observer& observer, WindowSize size) {
-  model_link_->port_.SubscribeObserver(observer, size);
+  {
+    std::lock_guard lock(model_link_->port_mutex_);
+    model_link_->port_.SubscribeObserver(observer, size);
+  }
   UpdateAll();
 }
 
+void Controller::RemoveView(Observer& observer) {
+  // The running frame may still be writing into the view's memory
+  model_link_->render_worker_.WaitIdle();
+  std::lock_guard lock(model_link_->port_mutex_);
+  model_link_->render_targets_.erase(&observer);
+  observer.Unsubscribe();
+}
+
 void Controller::AddLight(const Light& new_light) {
-  model_link_->lights_.push_back(new_light);
+  model_link_->PublishScene(
+      model_link_->GetScene()->WithLightAdded(new_light));
 }
 
 void Controller::ResizeWindow(Observer* observer, WindowSize new_size) {
-  model_link_->port_.SetDataByID(observer, new_size);
+  {
+    std::lock_guard lock(model_link_->port_mutex_);
+    model_link_->port_.SetDataByID(observer, new_size);
+  }
   UpdateAll();
 };
 
+void Controller::SetPerfCountersEnabled(bool enabled) {
+  model_link_->perf_counters_enabled_ = enabled;
+  UpdateAll();
+}
+
 void Controller::onMoveObject(Index index, ElemType dx, ElemType dy,
                               ElemType dz) {
-  if (index >= 0 && index < model_link_->objects_.size()) {
-    Point4 position = (*model_link_)(index).GetPosition();
+  Model::SceneSnapshotPtr scene = model_link_->GetScene();
+  if (index >= 0 && index < scene->GetObjectsCount()) {
+    Object object = scene->GetObject(index);
+    Point4 position = object.GetPosition();
     position(0) += dx;
     position(1) += dy;
     position(2) += dz;
-    (*model_link_)(index).SetPosition(position);
+    object.SetPosition(position);
+    model_link_->PublishScene(scene->WithObject(index, object));
     UpdateAll();
   }
 }
 
 void Controller::onMoveCamera(ElemType dx, ElemType dy, ElemType dz) {
-  Point4 position = model_link_->camera_.GetPosition();
+  Model::SceneSnapshotPtr scene = model_link_->GetScene();
+  Model::Camera camera = scene->GetCamera();
+  Point4 position = camera.GetPosition();
   position(0) += dx;
   position(1) += dy;
   position(2) += dz;
-  model_link_->camera_.SetPosition(position);
+  camera.SetPosition(position);
+  model_link_->PublishScene(scene->WithCamera(camera));
   UpdateAll();
 }
 
 void Controller::onRotateObject(Index index, ElemType rx, ElemType ry,
                                 ElemType rz) {
-  if (index >= 0 && index < model_link_->GetObjectsCount()) {
+  Model::SceneSnapshotPtr scene = model_link_->GetScene();
+  if (index >= 0 && index < scene->GetObjectsCount()) {
     TransformMatrix4x4 rotation_x = TransformMatrix4x4::MakeRotationX(rx);
     TransformMatrix4x4 rotation_y = TransformMatrix4x4::MakeRotationY(ry);
     TransformMatrix4x4 rotation_z = TransformMatrix4x4::MakeRotationZ(rz);
 
     TransformMatrix4x4 rotation_matrix = rotation_z * rotation_y * rotation_x;
 
-    Object& object = (*model_link_)(index);
-    for (Index i = 0; i < object.GetTrianglesCount(); ++i) {
-      object(i).vertices.Transform(rotation_matrix);
-      object(i).normals.Transform(rotation_matrix);
-    }
+    Object object = scene->GetObject(index);
+    object.Rotate(rotation_matrix);
+    model_link_->PublishScene(scene->WithObject(index, object));
 
     UpdateAll();
   }
 }
 
 void Controller::onRotateCamera(ElemType delta_pitch, ElemType delta_yaw) {
-  ElemType current_pitch = model_link_->camera_.GetPitch();
-  ElemType current_yaw = model_link_->camera_.GetYAW();
+  Model::SceneSnapshotPtr scene = model_link_->GetScene();
+  Model::Camera camera = scene->GetCamera();
+  ElemType current_pitch = camera.GetPitch();
+  ElemType current_yaw = camera.GetYAW();
 
-  model_link_->camera_.SetPitch(current_pitch + delta_pitch);
-  model_link_->camera_.SetYAW(current_yaw + delta_yaw);
+  camera.SetPitch(current_pitch + delta_pitch);
+  camera.SetYAW(current_yaw + delta_yaw);
+  model_link_->PublishScene(scene->WithCamera(camera));
 
   UpdateAll();
 }
 
 void Controller::onModelLoad(const QString& fileName) {
   std::string file_path = fileName.toStdString();
-  Scene::Object new_object = Scene::ObjParser::Parse(file_path);
+  Scene::Object new_object(model_link_->mesh_assets_.Load(file_path));
 
   AddObject(new_object);
   UpdateAll();
 }
 
 void Controller::UpdateAll() {
-  for (auto& elem : model_link_->port_.GetObserversList()) {
-    ScreenPicture renderer_output = model_link_->renderer_.RenderScene(
-        model_link_->objects_, model_link_->camera_, model_link_->lights_,
-        elem.second);
-    model_link_->port_.NotifyOne(elem.first, renderer_output);
-  }
+  // Marks the scene dirty: a frame requested while the previous one is
+  // still waiting replaces it, and the frame renders the version that is
+  // the latest when it starts
+  Model* model = model_link_;
+  model->render_worker_.Submit([model]() {
+    // Pinned for the whole frame, edits meanwhile publish new versions
+    Model::SceneSnapshotPtr scene = model->GetScene();
+    // The renderer fits the camera to each view
+    Model::Camera camera = scene->GetCamera();
+    model->renderer_.SetPerfCountersEnabled(model->perf_counters_enabled_);
+
+    std::vector<Observer*> observers;
+    {
+      std::lock_guard lock(model->port_mutex_);
+      for (auto& elem : model->port_.GetObserversList()) {
+        observers.push_back(elem.first);
+      }
+    }
+
+    for (Observer* observer : observers) {
+      // The view hands out the memory it presents from, so the frame is
+      // rendered in place and never copied. A view removed in the meantime
+      // hands out nothing.
+      FrameView frame{};
+      {
+        std::lock_guard lock(model->port_mutex_);
+        frame = model->port_.AcquireOne(observer);
+      }
+      if (!frame.pixels) {
+        continue;
+      }
+
+      RenderTarget& target = model->render_targets_[observer];
+      target.AttachColorBuffer(frame.pixels, frame.window_size);
+      model->renderer_.RenderScene(scene->GetObjects(), camera,
+                                   scene->GetLights(), target,
+                                   &scene->GetBVH());
+      frame.stats = &model->renderer_.GetFrameStats();
+
+      std::lock_guard lock(model->port_mutex_);
+      model->port_.NotifyOne(observer, frame);
+    }
+  });
 }
 
 }  // namespace Core
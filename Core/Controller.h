@@ -9,16 +9,17 @@ namespace Core {
 
 class Controller : public QObject {
   Q_OBJECT
-  using ScreenPicture = Detail::ScreenPicture;
+  using FrameView = Detail::FrameView;
   using Index = Linear::Index;
   using WindowSize = Detail::WindowSize;
   using Point4 = Linear::Point4;
-  using Observer = Detail::Observer<ScreenPicture, WindowSize>;
+  using Observer = Detail::Observer<FrameView, WindowSize>;
   using ElemType = Linear::ElemType;
   using TransformMatrix4x4 = Linear::TransformMatrix4x4;
   using TriangleData = Scene::TriangleData;
   using Object = Scene::Object;
   using Light = Detail::Light;
+  using RenderTarget = Rendering::RenderTarget;
 
 public:
   Controller(Model* model_link);
@@ -26,11 +27,19 @@ public:
   void AddObject(Scene::Object& object);
 
   void AddView(Observer& observer, WindowSize size);
+  // Waits for the frame in flight, after which the view gets no more frames
+  void RemoveView(Observer& observer);
 
   void AddLight(const Light& new_light);
 
   void ResizeWindow(Observer* observer, WindowSize new_size);
 
+  // Whether the frame statistics include hardware counters, from the next
+  // frame on
+  void SetPerfCountersEnabled(bool enabled);
+
+  // Schedules a frame of the current scene on the render worker and
+  // returns without waiting for it
   void UpdateAll();
 
 public slots:
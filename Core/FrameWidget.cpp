@@ -0,0 +1,43 @@
+#include "FrameWidget.h"
+#include <QPainter>
+
+namespace Core {
+
+FrameWidget::FrameWidget(QWidget* parent) : QWidget(parent) {
+  // Every pixel is covered by the frame, so Qt does not need to erase it
+  setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void FrameWidget::SetImage(const QImage& image) {
+  image_ = image;
+  update();
+}
+
+void FrameWidget::SetOverlayText(const QString& text) {
+  overlay_text_ = text;
+  update();
+}
+
+void FrameWidget::paintEvent(QPaintEvent*) {
+  QPainter painter(this);
+  if (image_.isNull()) {
+    painter.fillRect(rect(), Qt::black);
+    return;
+  }
+  // Scales only while the frame for a new size is not ready yet
+  painter.drawImage(rect(), image_);
+
+  if (overlay_text_.isEmpty()) {
+    return;
+  }
+  constexpr int kMARGIN = 6;
+  QRect text_rect = painter.boundingRect(
+      rect().adjusted(2 * kMARGIN, 2 * kMARGIN, 0, 0),
+      Qt::AlignLeft | Qt::AlignTop, overlay_text_);
+  painter.fillRect(text_rect.adjusted(-kMARGIN, -kMARGIN, kMARGIN, kMARGIN),
+                   QColor(0, 0, 0, 160));
+  painter.setPen(Qt::white);
+  painter.drawText(text_rect, Qt::AlignLeft | Qt::AlignTop, overlay_text_);
+}
+
+}  // namespace Core
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+#include <QWidget>
+
+namespace Core {
+
+// Shows a frame that is painted straight from the QImage the renderer wrote
+// into, without converting it to a QPixmap first.
+class FrameWidget : public QWidget {
+public:
+  explicit FrameWidget(QWidget* parent = nullptr);
+
+  // Keeps a shallow copy of the image until the next SetImage call
+  void SetImage(const QImage& image);
+
+  // Text drawn over the top left corner of the frame, none when empty
+  void SetOverlayText(const QString& text);
+
+protected:
+  void paintEvent(QPaintEvent* event) override;
+
+private:
+  QImage image_;
+  QString overlay_text_;
+};
+
+}  // namespace Core
@@ -1,18 +1,21 @@
 #include "Model.h"
-#include <cassert>
 
 namespace Core {
 
-Model::Model(QObject* parent) : QObject(parent) {
+Model::Model(QObject* parent)
+    : QObject(parent), scene_(std::make_shared<const SceneSnapshot>()) {
 }
 
-Scene::Object& Model::operator()(Index index) {
-  assert(index < objects_.size() && "Index out of range");
-  return objects_[index];
+Model::Index Model::GetObjectsCount() const {
+  return scene_.load()->GetObjectsCount();
 }
 
-Model::Index Model::GetObjectsCount() const {
-  return objects_.size();
+Scene::SceneSnapshotPtr Model::GetScene() const {
+  return scene_.load();
+}
+
+void Model::PublishScene(SceneSnapshot&& scene) {
+  scene_.store(std::make_shared<const SceneSnapshot>(std::move(scene)));
 }
 
 }  // namespace Core
@@ -1,12 +1,17 @@
 #pragma once
 
 #include <QObject>
+#include <atomic>
 #include <list>
+#include <map>
+#include <mutex>
 #include <vector>
 #include "../Detail/Observer.h"
 #include "../Detail/Palette.h"
+#include "../Object/SceneSnapshot.h"
 #include "../Renderer/Renderer.h"
 #include "Controller.h"
+#include "RenderWorker.h"
 
 namespace Core {
 
@@ -20,6 +25,7 @@ class Model : public QObject {
 public:
   using Object = Scene::Object;
   using Renderer = Rendering::Renderer;
+  using RenderTarget = Rendering::RenderTarget;
   using Camera = Scene::Camera;
   using Light = Detail::Light;
 
@@ -27,24 +33,48 @@ public:
   using Cameras = std::vector<Camera>;
   using Lights = Detail::Lights;
 
-  using ScreenPicture = Detail::ScreenPicture;
+  using FrameView = Detail::FrameView;
   using WindowSize = Detail::WindowSize;
-  using Observable = Detail::Observable<ScreenPicture, WindowSize>;
-  using Observer = Detail::Observer<ScreenPicture, WindowSize>;
+  using Observable = Detail::Observable<FrameView, WindowSize>;
+  using Observer = Detail::Observer<FrameView, WindowSize>;
   using Index = Linear::Index;
+  using SceneSnapshot = Scene::SceneSnapshot;
+  using SceneSnapshotPtr = Scene::SceneSnapshotPtr;
 
   explicit Model(QObject* parent = nullptr);
-  Object& operator()(Index);
 
   Index GetObjectsCount() const;
 
+  // Pins the latest version of the scene, which stays valid and unchanged
+  // for as long as the pointer is held, whatever is published meanwhile
+  SceneSnapshotPtr GetScene() const;
+
+  // Makes scene the latest version. Versions are published by one thread at
+  // a time, which derives each from the one it published before.
+  void PublishScene(SceneSnapshot&& scene);
+
 private:
+  // Used by the render worker only
   Renderer renderer_;
-  Objects objects_;
-  Lights lights_;
-  Camera camera_;
+  // Frame buffers of every view, reused between frames
+  std::map<Observer*, RenderTarget> render_targets_;
+  // Set by the GUI thread, applied to the renderer before every frame
+  std::atomic<bool> perf_counters_enabled_ = false;
 
+  // Latest version of the scene, swapped as a whole by every edit. It is not
+  // lock-free in libstdc++, whose loads and stores take a short internal
+  // lock, which is fine for one load per frame and one store per edit.
+  std::atomic<SceneSnapshotPtr> scene_;
+  // Meshes loaded from files, shared by all objects placed from one file
+  Scene::MeshAssetCache mesh_assets_;
+
+  // Guards port_, which both the GUI thread and the render worker use
+  std::mutex port_mutex_;
   Observable port_;
+
+  // Last, so that the running frame finishes before anything it uses is
+  // destroyed
+  RenderWorker render_worker_;
 };
 
 }  // namespace Core
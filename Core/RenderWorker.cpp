@@ -0,0 +1,58 @@
+#include "RenderWorker.h"
+#include "../Profiling/Trace.h"
+
+namespace Core {
+
+RenderWorker::RenderWorker() : thread_([this]() { WorkerLoop(); }) {
+}
+
+RenderWorker::~RenderWorker() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+    pending_job_ = nullptr;
+  }
+  job_condition_.notify_one();
+  thread_.join();
+}
+
+void RenderWorker::Submit(Job&& job) {
+  {
+    std::lock_guard lock(mutex_);
+    pending_job_ = std::move(job);
+  }
+  job_condition_.notify_one();
+}
+
+void RenderWorker::WaitIdle() {
+  std::unique_lock lock(mutex_);
+  idle_condition_.wait(lock, [this]() { return !running_ && !pending_job_; });
+}
+
+void RenderWorker::WorkerLoop() {
+  Profiling::SetThreadName("render worker");
+  while (true) {
+    Job job;
+    {
+      std::unique_lock lock(mutex_);
+      job_condition_.wait(lock,
+                          [this]() { return stopping_ || pending_job_; });
+      if (stopping_) {
+        return;
+      }
+      job = std::move(pending_job_);
+      pending_job_ = nullptr;
+      running_ = true;
+    }
+
+    job();
+
+    {
+      std::lock_guard lock(mutex_);
+      running_ = false;
+    }
+    idle_condition_.notify_all();
+  }
+}
+
+}  // namespace Core
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Core {
+
+// Dedicated rendering thread with a single pending job slot. Submitting a
+// job while another one is still pending replaces it, so a burst of scene
+// changes costs at most one frame in flight plus one frame of the latest
+// state, and the submitting thread never waits for a render.
+class RenderWorker {
+public:
+  using Job = std::function<void()>;
+
+  RenderWorker();
+  // Finishes the running job and drops the pending one
+  ~RenderWorker();
+
+  RenderWorker(const RenderWorker&) = delete;
+  RenderWorker& operator=(const RenderWorker&) = delete;
+
+  void Submit(Job&& job);
+
+  // Blocks until there is neither a pending nor a running job
+  void WaitIdle();
+
+private:
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  std::condition_variable job_condition_;
+  std::condition_variable idle_condition_;
+
+  Job pending_job_;
+  bool running_ = false;
+  bool stopping_ = false;
+
+  // Last, so that it starts after the other members are initialized
+  std::thread thread_;
+};
+
+}  // namespace Core
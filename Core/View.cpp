@@ -1,20 +1,72 @@
 #include "View.h"
 #include <QDebug>
+#include <QMetaObject>
 #include <QResizeEvent>
+#include <QStringList>
 #include <vector>
+#include "../Profiling/PerfCounters.h"
+#include "../Profiling/Trace.h"
 #include "Controller.h"
 
 namespace Core {
 
+namespace {
+
+// Event counts shortened to thousands or millions
+QString FormatCount(uint64_t count) {
+  if (count < 10'000) {
+    return QString::number(count);
+  }
+  if (count < 10'000'000) {
+    return QString("%1k").arg(count / 1e3, 0, 'f', 1);
+  }
+  return QString("%1M").arg(count / 1e6, 0, 'f', 1);
+}
+
+QString FormatFrameStats(const Detail::FrameStats& stats) {
+  using FrameStats = Detail::FrameStats;
+  using PerfCounterValues = Profiling::PerfCounterValues;
+  QStringList lines;
+  lines << QString("frame %1 ms").arg(stats.frame_milliseconds, 0, 'f', 2);
+  for (Linear::Index stage = 0; stage < FrameStats::kSTAGES_COUNT; ++stage) {
+    QString line = QString("  %1 %2 ms")
+                       .arg(FrameStats::kSTAGE_NAMES[stage])
+                       .arg(stats.stage_milliseconds[stage], 0, 'f', 2);
+    for (int counter = 0; stats.has_perf_counters &&
+                          counter < PerfCounterValues::kCOUNTERS_COUNT;
+         ++counter) {
+      line += QString(", %1 %2")
+                  .arg(FormatCount(stats.stage_counters[stage].counts[counter]))
+                  .arg(PerfCounterValues::kCOUNTER_NAMES[counter]);
+    }
+    lines << line;
+  }
+  lines << QString("objects %1, frustum culled %2, occluded %3")
+               .arg(stats.objects_in)
+               .arg(stats.objects_frustum_culled)
+               .arg(stats.objects_occluded);
+  lines << QString("triangles %1, backface culled %2, clipped %3, emitted %4")
+               .arg(stats.triangles_in)
+               .arg(stats.triangles_backface_culled)
+               .arg(stats.triangles_clipped)
+               .arg(stats.triangles_emitted);
+  lines << QString("pixels tested %1, written %2, overdraw %3")
+               .arg(stats.pixels_tested)
+               .arg(stats.pixels_written)
+               .arg(stats.GetOverdraw(), 0, 'f', 2);
+  return lines.join('\n');
+}
+
+}  // namespace
+
 View::View(Controller* controller_link)
     : port_(), controller_(controller_link) {
   QWidget* central_widget = new QWidget(this);
   QHBoxLayout* main_layout = new QHBoxLayout(central_widget);
 
-  label_ = new QLabel(central_widget);
-  label_->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
-  label_->setScaledContents(true);
-  main_layout->addWidget(label_, 1);
+  frame_widget_ = new FrameWidget(central_widget);
+  frame_widget_->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
+  main_layout->addWidget(frame_widget_, 1);
 
   control_panel_ = new QWidget(central_widget);
   QVBoxLayout* panel_layout = new QVBoxLayout(control_panel_);
@@ -75,6 +127,48 @@ View::View(Controller* controller_link)
   configureButton(btnLoadModel);
   panel_layout->addWidget(btnLoadModel);
 
+  if constexpr (Detail::kFRAME_STATS_ENABLED) {
+    QPushButton* btnStats = new QPushButton("Show frame stats");
+    btnStats->setCheckable(true);
+    configureButton(btnStats);
+    panel_layout->addWidget(btnStats);
+    connect(btnStats, &QPushButton::toggled, this, [this](bool checked) {
+      show_stats_ = checked;
+      if (!checked) {
+        frame_widget_->SetOverlayText({});
+      }
+    });
+
+    QPushButton* btnCounters = new QPushButton("Hardware counters");
+    btnCounters->setCheckable(true);
+    configureButton(btnCounters);
+    panel_layout->addWidget(btnCounters);
+    connect(btnCounters, &QPushButton::toggled, this, [this](bool checked) {
+      controller_->SetPerfCountersEnabled(checked);
+    });
+  }
+
+  if constexpr (Profiling::kTRACING_ENABLED) {
+    QPushButton* btnTrace = new QPushButton("Record trace");
+    btnTrace->setCheckable(true);
+    configureButton(btnTrace);
+    panel_layout->addWidget(btnTrace);
+    connect(btnTrace, &QPushButton::toggled, this, [this](bool checked) {
+      if (checked) {
+        Profiling::StartTracing();
+        return;
+      }
+      Profiling::StopTracing();
+      QString fileName = QFileDialog::getSaveFileName(
+          this, tr("Save Trace"), "trace.json",
+          tr("Chrome Trace (*.json);;All Files (*)"));
+      if (!fileName.isEmpty() &&
+          !Profiling::WriteTrace(fileName.toStdString())) {
+        qDebug() << "Cannot write trace to" << fileName;
+      }
+    });
+  }
+
   setCentralWidget(central_widget);
 
   constexpr ElemType moveStep = 1;
@@ -150,34 +244,86 @@ View::View(Controller* controller_link)
   connect(this, &View::modelLoadRequested, controller_,
           &Controller::onModelLoad);
 
-  port_.SetNotifyAction([this](ScreenPicture& data) { this->Draw(data); });
+  port_.SetAcquireAction(
+      [this](const WindowSize& size) { return this->AcquireFrame(size); });
+  port_.SetNotifyAction([this](FrameView& data) { this->Draw(data); });
   controller_->AddView(port_, GetWindowSize());
   controller_->UpdateAll();
   show();
 }
 
+View::~View() {
+  controller_->RemoveView(port_);
+}
+
 void View::resizeEvent(QResizeEvent* event) {
   qDebug() << "Resize event triggered, new size:" << event->size();
   QMainWindow::resizeEvent(event);
   controller_->ResizeWindow(&port_, GetWindowSize());
 }
 
-void View::Draw(Detail::ScreenPicture& screen_picture) {
-  int imageWidth = label_->width();
-  int imageHeight = label_->height();
+Detail::FrameView View::AcquireFrame(WindowSize window_size) {
+  {
+    std::lock_guard lock(frames_mutex_);
+    back_frame_ = 0;
+    while (back_frame_ == shown_frame_ || back_frame_ == pending_frame_) {
+      ++back_frame_;
+    }
+  }
 
-  QImage image(reinterpret_cast<uchar*>(screen_picture.data()), imageWidth,
-               imageHeight, QImage::Format_RGB32);
+  Frame& frame = frames_[back_frame_];
+  if (frame.image.height() != window_size.height ||
+      frame.image.width() != window_size.width) {
+    Index width = window_size.width;
+    frame.pixels.assign(width * window_size.height, 0);
+    // 32-bit pixels keep rows contiguous, matching the renderer's layout
+    frame.image = QImage(reinterpret_cast<uchar*>(frame.pixels.data()),
+                         window_size.width, window_size.height,
+                         width * sizeof(Detail::Color), QImage::Format_RGB32);
+  }
+  return {.pixels = frame.pixels.data(), .window_size = window_size};
+}
 
-  QPixmap pixmap = QPixmap::fromImage(image);
-  label_->setPixmap(pixmap);
+void View::Draw(FrameView& frame) {
+  // Only a frame handed out by AcquireFrame can be presented
+  if (frame.pixels != frames_[back_frame_].pixels.data()) {
+    return;
+  }
+  bool present_posted = false;
+  {
+    std::lock_guard lock(frames_mutex_);
+    frames_[back_frame_].stats = frame.stats ? *frame.stats : FrameStats{};
+    present_posted = pending_frame_ != kNO_FRAME;
+    pending_frame_ = back_frame_;
+  }
+  if (!present_posted) {
+    QMetaObject::invokeMethod(
+        this, [this]() { Present(); }, Qt::QueuedConnection);
+  }
+}
 
-  return;
+void View::Present() {
+  FrameStats stats;
+  {
+    std::lock_guard lock(frames_mutex_);
+    if (pending_frame_ == kNO_FRAME) {
+      return;
+    }
+    // The widget lets go of the shown frame here, so it may be freed
+    const Frame& frame = frames_[pending_frame_];
+    frame_widget_->SetImage(frame.image);
+    stats = frame.stats;
+    shown_frame_ = pending_frame_;
+    pending_frame_ = kNO_FRAME;
+  }
+  if (show_stats_) {
+    frame_widget_->SetOverlayText(FormatFrameStats(stats));
+  }
 }
 
 Detail::WindowSize View::GetWindowSize() const {
-  return {Linear::Detail::Height{label_->height()},
-          Linear::Detail::Width{label_->width()}};
+  return {Linear::Detail::Height{frame_widget_->height()},
+          Linear::Detail::Width{frame_widget_->width()}};
 }
 
 }  // namespace Core
@@ -2,32 +2,43 @@
 
 #include <QFileDialog>
 #include <QHBoxLayout>
-#include <QLabel>
+#include <QImage>
 #include <QMainWindow>
-#include <QPixmap>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QWidget>
+#include <array>
+#include <mutex>
 #include <vector>
 #include "../Detail/Observer.h"
 #include "../Detail/Palette.h"
 #include "Controller.h"
+#include "FrameWidget.h"
 
 namespace Core {
 
 class View : public QMainWindow {
   Q_OBJECT
   using ElemType = Linear::ElemType;
-  using ScreenPicture = Detail::ScreenPicture;
+  using FrameView = Detail::FrameView;
+  using FrameStats = Detail::FrameStats;
   using WindowSize = Detail::WindowSize;
-  using Observer = Detail::Observer<ScreenPicture, WindowSize>;
+  using Observer = Detail::Observer<FrameView, WindowSize>;
   using Camera = Scene::Camera;
   using Index = Linear::Index;
 
 public:
   View(Controller* controller_link);
+  ~View() override;
 
-  void Draw(ScreenPicture& screen_picture);
+  // Returns a frame the GUI is done with, resized to window_size, for the
+  // renderer to write the next frame into. Called on the render worker.
+  FrameView AcquireFrame(WindowSize window_size);
+
+  // Hands the frame returned by the last AcquireFrame call to the GUI thread
+  // for presenting, along with its statistics. A frame still waiting to be
+  // presented is dropped for the newer one. Called on the render worker.
+  void Draw(FrameView& frame);
 
   WindowSize GetWindowSize() const;
 
@@ -44,11 +55,36 @@ protected:
   void resizeEvent(QResizeEvent* event) override;
 
 private:
-  QLabel* label_;
+  static constexpr Index kNO_FRAME = -1;
+
+  // Pixels the renderer writes into, shown through an image that wraps them
+  // without owning them, so that it never detaches into a copy
+  struct Frame {
+    std::vector<Detail::Color> pixels;
+    QImage image;
+    FrameStats stats;
+  };
+
+  // Shows the frame waiting since the last Draw, on the GUI thread
+  void Present();
+
+  FrameWidget* frame_widget_;
   Controller* controller_;
   Observer port_;
 
+  // Triple buffering: while one frame is shown and another waits to be
+  // presented, the renderer writes into the third
+  std::array<Frame, 3> frames_;
+  // Written into by the render worker
+  Index back_frame_ = 0;
+  // Guards which frames the GUI holds
+  std::mutex frames_mutex_;
+  Index pending_frame_ = kNO_FRAME;
+  Index shown_frame_ = kNO_FRAME;
+
   QWidget* control_panel_;
+  // Whether the statistics of each frame are drawn over it
+  bool show_stats_ = false;
 };
 
 }  // namespace Core
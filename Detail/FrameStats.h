@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "../MathUtils/Matrix.h"
+#include "../Profiling/PerfCounters.h"
+
+namespace Detail {
+
+#ifdef RENDERER_FRAME_STATS
+inline constexpr bool kFRAME_STATS_ENABLED = true;
+#else
+inline constexpr bool kFRAME_STATS_ENABLED = false;
+#endif
+
+// Where the time of one frame went and how much work every stage did. Filled
+// by the renderer only when it is built with RENDERER_FRAME_STATS, otherwise
+// all of it stays zero.
+struct FrameStats {
+  using Index = Linear::Index;
+
+  enum Stage : Index {
+    // Frustum and occlusion culling of whole objects
+    kCULLING,
+    // Vertex transform and backface culling of the visible objects
+    kVERTEX_PROCESSING,
+    // Triangle assembly, clipping and screen mapping
+    kTRIANGLE_SETUP,
+    kBINNING,
+    // Coverage and depth test, shading included in the forward mode
+    kRASTERIZATION,
+    // Lighting and texturing of the deferred mode
+    kSHADING,
+    kSTAGES_COUNT
+  };
+
+  static constexpr std::array<const char*, kSTAGES_COUNT> kSTAGE_NAMES{
+      "culling", "vertex processing", "triangle setup",
+      "binning", "rasterization",     "shading"};
+
+  // Pixel writes per pixel of the screen
+  double GetOverdraw() const {
+    return screen_pixels ? static_cast<double>(pixels_written) / screen_pixels
+                         : 0;
+  }
+
+  // In milliseconds. Stages run per tile add up the time of all threads.
+  std::array<double, kSTAGES_COUNT> stage_milliseconds{};
+  double frame_milliseconds = 0;
+
+  Index objects_in = 0;
+  Index objects_frustum_culled = 0;
+  Index objects_occluded = 0;
+
+  // Triangles of the objects that survived culling
+  Index triangles_in = 0;
+  Index triangles_backface_culled = 0;
+  // Triangles crossing the frustum, cut into smaller ones
+  Index triangles_clipped = 0;
+  // Triangles handed to the rasterizer
+  Index triangles_emitted = 0;
+
+  // Covered pixels that went through the depth test
+  uint64_t pixels_tested = 0;
+  uint64_t pixels_written = 0;
+  uint64_t screen_pixels = 0;
+
+  // Hardware events per stage, when Renderer::SetPerfCountersEnabled is on
+  // and the system grants the counters. Stages run per tile add up all
+  // threads.
+  bool has_perf_counters = false;
+  std::array<Profiling::PerfCounterValues, kSTAGES_COUNT> stage_counters{};
+};
+
+// Adds its lifetime to a stage timer. Compiles to nothing without the stats.
+template <bool kENABLED = kFRAME_STATS_ENABLED>
+class ScopedStageTimer {
+  using Clock = std::chrono::steady_clock;
+
+public:
+  explicit ScopedStageTimer(double& milliseconds)
+      : milliseconds_(milliseconds), begin_(Clock::now()) {
+  }
+
+  ~ScopedStageTimer() {
+    milliseconds_ +=
+        std::chrono::duration<double, std::milli>(Clock::now() - begin_)
+            .count();
+  }
+
+  ScopedStageTimer(const ScopedStageTimer&) = delete;
+  ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+  double& milliseconds_;
+  Clock::time_point begin_;
+};
+
+template <>
+class ScopedStageTimer<false> {
+public:
+  explicit ScopedStageTimer(double&) {
+  }
+};
+
+// Adds the hardware events of the calling thread during its lifetime to a
+// stage, unless counters is null. Compiles to nothing without the stats.
+template <bool kENABLED = kFRAME_STATS_ENABLED>
+class ScopedStageCounters {
+  using PerfCounterValues = Profiling::PerfCounterValues;
+
+public:
+  ScopedStageCounters(const Profiling::ThreadPerfCounters* counters,
+                      PerfCounterValues& values)
+      : counters_(counters), values_(values) {
+    if (counters_) {
+      begin_ = counters_->Read();
+    }
+  }
+
+  ~ScopedStageCounters() {
+    if (counters_) {
+      values_ += counters_->Read() - begin_;
+    }
+  }
+
+  ScopedStageCounters(const ScopedStageCounters&) = delete;
+  ScopedStageCounters& operator=(const ScopedStageCounters&) = delete;
+
+private:
+  const Profiling::ThreadPerfCounters* counters_;
+  PerfCounterValues& values_;
+  PerfCounterValues begin_;
+};
+
+template <>
+class ScopedStageCounters<false> {
+public:
+  ScopedStageCounters(const Profiling::ThreadPerfCounters*,
+                      Profiling::PerfCounterValues&) {
+  }
+};
+
+}  // namespace Detail
@@ -27,6 +27,7 @@ public:
     observable_->detach_(this);
     observable_ = nullptr;
     notify_action_ = nullptr;
+    acquire_action_ = nullptr;
   }
 
   bool IsSubscribed() const {
@@ -37,6 +38,12 @@ public:
     notify_action_ = std::move(new_func);
   }
 
+  // Lets the observable ask the observer for the storage of the next
+  // notification, given the observer's ID_Data
+  void SetAcquireAction(std::function<Data(const ID_Data&)>&& new_func) {
+    acquire_action_ = std::move(new_func);
+  }
+
   ~Observer() {
     Unsubscribe();
   }
@@ -48,6 +55,7 @@ private:
 
   Observable* observable_;
   std::function<void(Data&)> notify_action_;
+  std::function<Data(const ID_Data&)> acquire_action_;
 };
 
 template <class Data, typename ID_Data>
@@ -87,6 +95,15 @@ public:
     }
   }
 
+  Data AcquireOne(Observer* observer) {
+    for (auto it = observers_.begin(); it != observers_.end(); ++it) {
+      if (it->first == observer && it->first->acquire_action_) {
+        return it->first->acquire_action_(it->second);
+      }
+    }
+    return Data{};
+  }
+
   std::list<std::pair<Observer*, ID_Data>>& GetObserversList() {
     return observers_;
   }
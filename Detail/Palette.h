@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 #include "../MathUtils/Point4.h"
+#include "FrameStats.h"
 
 namespace Detail {
 
@@ -19,6 +20,14 @@ struct WindowSize {
   Width width;
 };
 
+// Non-owning view of a color buffer of window_size.width * window_size.height
+// pixels, row by row. A rendered frame may come with its statistics.
+struct FrameView {
+  Color* pixels;
+  WindowSize window_size;
+  const FrameStats* stats = nullptr;
+};
+
 struct ScreenPoint {
   using Height = Linear::Detail::Height;
   using Width = Linear::Detail::Width;
@@ -36,10 +45,10 @@ struct Light {
   using Point4 = Linear::Point4;
 
   enum class LightType { Directional, Point };
-  LightType type;
+  LightType type = LightType::Directional;
 
-  Point4 direction;
-  Point4 position;
+  Point4 direction{};
+  Point4 position{};
 
   ElemType ambient = 0.2;
   ElemType diffuse = 1.0;
@@ -0,0 +1,66 @@
+#include "ImageWriter.h"
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "stb_image_write.h"
+
+namespace Headless {
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// Pixels as 8-bit RGB triples, row by row
+Bytes ToRGB(const Detail::ScreenPicture& picture) {
+  Bytes result;
+  result.reserve(picture.size() * 3);
+  for (Detail::Color color : picture) {
+    result.push_back(color >> 16);
+    result.push_back(color >> 8);
+    result.push_back(color);
+  }
+  return result;
+}
+
+bool EndsWith(const std::string& text, const std::string& suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+}  // namespace
+
+bool WriteImage(const std::string& path, const Detail::ScreenPicture& picture,
+                Detail::WindowSize window_size) {
+  if (EndsWith(path, ".png") || EndsWith(path, ".PNG")) {
+    return WritePNG(path, picture, window_size);
+  }
+  return WritePPM(path, picture, window_size);
+}
+
+bool WritePPM(const std::string& path, const Detail::ScreenPicture& picture,
+              Detail::WindowSize window_size) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    std::cerr << "Cannot write image: " << path << "\n";
+    return false;
+  }
+  out << "P6\n" << window_size.width << " " << window_size.height << "\n255\n";
+  Bytes pixels = ToRGB(picture);
+  out.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+  return static_cast<bool>(out);
+}
+
+bool WritePNG(const std::string& path, const Detail::ScreenPicture& picture,
+              Detail::WindowSize window_size) {
+  Bytes pixels = ToRGB(picture);
+  if (!stbi_write_png(path.c_str(), window_size.width, window_size.height, 3,
+                      pixels.data(), window_size.width * 3)) {
+    std::cerr << "Cannot write image: " << path << "\n";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace Headless
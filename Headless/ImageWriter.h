@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include "../Detail/Palette.h"
+
+namespace Headless {
+
+// Writes picture as binary PPM, or as PNG when path ends in ".png"
+bool WriteImage(const std::string& path, const Detail::ScreenPicture& picture,
+                Detail::WindowSize window_size);
+
+bool WritePPM(const std::string& path, const Detail::ScreenPicture& picture,
+              Detail::WindowSize window_size);
+
+bool WritePNG(const std::string& path, const Detail::ScreenPicture& picture,
+              Detail::WindowSize window_size);
+
+}  // namespace Headless
@@ -0,0 +1,241 @@
+#include "SceneDescription.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace Headless {
+
+namespace {
+
+using Light = Detail::Light;
+
+bool ParseLightType(const std::string& name, Light::LightType& type) {
+  if (name == "point") {
+    type = Light::LightType::Point;
+    return true;
+  }
+  if (name == "directional") {
+    type = Light::LightType::Directional;
+    return true;
+  }
+  return false;
+}
+
+Light MakeLight(Light::LightType type, const Linear::Point4& coordinates) {
+  Light light{.type = type};
+  if (type == Light::LightType::Point) {
+    light.position = {coordinates(0), coordinates(1), coordinates(2), 1};
+  } else {
+    light.direction = {coordinates(0), coordinates(1), coordinates(2), 0};
+  }
+  return light;
+}
+
+bool ReadPoint(std::istream& stream, Linear::ElemType w,
+               Linear::Point4& point) {
+  Linear::ElemType x, y, z;
+  if (!(stream >> x >> y >> z)) {
+    return false;
+  }
+  point = {x, y, z, w};
+  return true;
+}
+
+// "x,y,z" as given on the command line
+bool ParsePoint(std::string text, Linear::ElemType w, Linear::Point4& point) {
+  for (char& symbol : text) {
+    if (symbol == ',') {
+      symbol = ' ';
+    }
+  }
+  std::istringstream stream(text);
+  std::string rest;
+  return ReadPoint(stream, w, point) && !(stream >> rest);
+}
+
+bool ParseResolution(std::istream& stream, Detail::WindowSize& window_size) {
+  int width, height;
+  if (!(stream >> width >> height) || width <= 0 || height <= 0) {
+    return false;
+  }
+  window_size = {Linear::Detail::Height{height}, Linear::Detail::Width{width}};
+  return true;
+}
+
+bool ParseStatement(const std::string& keyword, std::istream& stream,
+                    SceneDescription& description) {
+  if (keyword == "model") {
+    ModelPlacement model;
+    if (!(stream >> model.path)) {
+      return false;
+    }
+    // The position is optional
+    if (!(stream >> std::ws).eof() &&
+        !ReadPoint(stream, 1, model.position)) {
+      return false;
+    }
+    description.models.push_back(model);
+    return true;
+  }
+  if (keyword == "camera") {
+    return ReadPoint(stream, 1, description.camera_position);
+  }
+  if (keyword == "look_at") {
+    Linear::Point4 point;
+    if (!ReadPoint(stream, 1, point)) {
+      return false;
+    }
+    description.look_at = point;
+    return true;
+  }
+  if (keyword == "light") {
+    std::string type_name;
+    Light::LightType type;
+    Linear::Point4 coordinates;
+    if (!(stream >> type_name) || !ParseLightType(type_name, type) ||
+        !ReadPoint(stream, 0, coordinates)) {
+      return false;
+    }
+    description.lights.push_back(MakeLight(type, coordinates));
+    return true;
+  }
+  if (keyword == "resolution") {
+    return ParseResolution(stream, description.window_size);
+  }
+  if (keyword == "output") {
+    return static_cast<bool>(stream >> description.output_path);
+  }
+  if (keyword == "shading") {
+    std::string mode;
+    if (!(stream >> mode) || (mode != "forward" && mode != "deferred")) {
+      return false;
+    }
+    description.deferred_shading = mode == "deferred";
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool ReadSceneFile(const std::string& path, SceneDescription& description) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "Cannot open scene: " << path << "\n";
+    return false;
+  }
+  // Model paths are relative to the scene file
+  std::string base = path.substr(0, path.find_last_of("/\\") + 1);
+
+  std::string line;
+  for (int line_number = 1; std::getline(in, line); ++line_number) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream stream(line);
+    std::string keyword;
+    if (!(stream >> keyword)) {
+      continue;
+    }
+    size_t models_count = description.models.size();
+    if (!ParseStatement(keyword, stream, description)) {
+      std::cerr << path << ":" << line_number << ": cannot parse \"" << line
+                << "\"\n";
+      return false;
+    }
+    if (description.models.size() > models_count &&
+        description.models.back().path.front() != '/') {
+      description.models.back().path = base + description.models.back().path;
+    }
+  }
+  return true;
+}
+
+bool ParseCommandLine(int argc, char** argv, SceneDescription& description) {
+  for (int i = 1; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option.empty() || option.front() != '-') {
+      if (!ReadSceneFile(option, description)) {
+        return false;
+      }
+      continue;
+    }
+    if (option == "--deferred") {
+      description.deferred_shading = true;
+      continue;
+    }
+
+    if (i + 1 == argc) {
+      std::cerr << "Missing value for " << option << "\n";
+      return false;
+    }
+    std::string value = argv[++i];
+    bool parsed = true;
+    if (option == "--scene") {
+      if (!ReadSceneFile(value, description)) {
+        return false;
+      }
+    } else if (option == "--model") {
+      // FILE or FILE@x,y,z
+      ModelPlacement model{.path = value.substr(0, value.rfind('@'))};
+      if (model.path.size() != value.size()) {
+        parsed = ParsePoint(value.substr(model.path.size() + 1), 1,
+                            model.position);
+      }
+      description.models.push_back(model);
+    } else if (option == "--camera") {
+      parsed = ParsePoint(value, 1, description.camera_position);
+    } else if (option == "--look-at") {
+      Linear::Point4 point;
+      parsed = ParsePoint(value, 1, point);
+      description.look_at = point;
+    } else if (option == "--point-light" ||
+               option == "--directional-light") {
+      Linear::Point4 coordinates;
+      parsed = ParsePoint(value, 0, coordinates);
+      description.lights.push_back(
+          MakeLight(option == "--point-light" ? Light::LightType::Point
+                                              : Light::LightType::Directional,
+                    coordinates));
+    } else if (option == "--size") {
+      // WIDTHxHEIGHT
+      for (char& symbol : value) {
+        if (symbol == 'x') {
+          symbol = ' ';
+        }
+      }
+      std::istringstream stream(value);
+      parsed = ParseResolution(stream, description.window_size);
+    } else if (option == "--output") {
+      description.output_path = value;
+    } else if (option == "--trace") {
+      description.trace_path = value;
+    } else {
+      std::cerr << "Unknown option " << option << "\n";
+      return false;
+    }
+
+    if (!parsed) {
+      std::cerr << "Cannot parse " << option << " " << value << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+void PrintUsage(const char* program_name) {
+  std::cerr
+      << "Usage: " << program_name << " [options] [scene-file]...\n"
+      << "Renders one frame without a window. Scene files and options are\n"
+      << "applied left to right, later ones override earlier ones.\n\n"
+      << "  --scene FILE               read a scene file\n"
+      << "  --model FILE[@X,Y,Z]       place an OBJ model\n"
+      << "  --camera X,Y,Z             camera position\n"
+      << "  --look-at X,Y,Z            point the camera looks at\n"
+      << "  --point-light X,Y,Z        add a point light\n"
+      << "  --directional-light X,Y,Z  add a directional light\n"
+      << "  --size WIDTHxHEIGHT        image size, 640x480 by default\n"
+      << "  --output FILE              .ppm or .png, frame.ppm by default\n"
+      << "  --deferred                 use deferred shading\n"
+      << "  --trace FILE               write a Chrome trace of the run\n";
+}
+
+}  // namespace Headless
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "../Detail/Palette.h"
+#include "../MathUtils/Point4.h"
+
+namespace Headless {
+
+struct ModelPlacement {
+  std::string path;
+  Linear::Point4 position = {0, 0, 0, 1};
+};
+
+// Everything needed to render one frame without a window, read from a
+// scene file and the command line.
+//
+// Scene files hold one statement per line, '#' starts a comment:
+//   model <file.obj> [x y z]
+//   camera <x y z>
+//   look_at <x y z>
+//   light point|directional <x y z>
+//   resolution <width> <height>
+//   output <file.ppm|file.png>
+//   shading forward|deferred
+struct SceneDescription {
+  using Point4 = Linear::Point4;
+
+  std::vector<ModelPlacement> models;
+  Point4 camera_position = {0, 0, 0, 1};
+  std::optional<Point4> look_at;
+  Detail::Lights lights;
+  Detail::WindowSize window_size = {Linear::Detail::Height{480},
+                                    Linear::Detail::Width{640}};
+  std::string output_path = "frame.ppm";
+  bool deferred_shading = false;
+  // Chrome trace of the loading and the frame, none when empty
+  std::string trace_path;
+};
+
+// Applies the statements of the scene file on top of description, reporting
+// the first malformed line to std::cerr
+bool ReadSceneFile(const std::string& path, SceneDescription& description);
+
+// Applies the command line on top of description, see PrintUsage
+bool ParseCommandLine(int argc, char** argv, SceneDescription& description);
+
+void PrintUsage(const char* program_name);
+
+}  // namespace Headless
@@ -0,0 +1,66 @@
+#include <iostream>
+#include <vector>
+#include "../Object/BVH.h"
+#include "../Object/MeshAsset.h"
+#include "../Profiling/Trace.h"
+#include "../Renderer/Renderer.h"
+#include "ImageWriter.h"
+#include "SceneDescription.h"
+
+// Renders one frame of a scene without a window and writes it to a file
+int main(int argc, char* argv[]) {
+  Headless::SceneDescription description;
+  if (argc < 2 || !Headless::ParseCommandLine(argc, argv, description)) {
+    Headless::PrintUsage(argv[0]);
+    return 1;
+  }
+
+  if (!description.trace_path.empty()) {
+    Profiling::SetThreadName("main");
+    Profiling::StartTracing();
+  }
+
+  Scene::MeshAssetCache mesh_assets;
+  std::vector<Scene::Object> objects;
+  for (const auto& model : description.models) {
+    Scene::Object object(mesh_assets.Load(model.path));
+    if (object.GetTrianglesCount() == 0) {
+      std::cerr << "No triangles in " << model.path << "\n";
+      return 1;
+    }
+    object.SetPosition(model.position);
+    objects.push_back(object);
+  }
+  Scene::BVH bvh;
+  bvh.Build(objects);
+
+  Scene::Camera camera(description.camera_position);
+  if (description.look_at) {
+    // The view looks down the negative forward axis, so the forward axis is
+    // pointed at the mirror image of the target
+    Linear::Point4 away =
+        2 * description.camera_position - *description.look_at;
+    camera.LookAtPoint(away);
+  }
+
+  Rendering::Renderer renderer;
+  if (description.deferred_shading) {
+    renderer.SetShadingMode(Rendering::ShadingMode::Deferred);
+  }
+  Rendering::RenderTarget target(description.window_size);
+  renderer.RenderScene(objects, camera, description.lights, target, &bvh);
+
+  if (!description.trace_path.empty()) {
+    Profiling::StopTracing();
+    if (!Profiling::WriteTrace(description.trace_path)) {
+      std::cerr << "Cannot write " << description.trace_path << "\n";
+      return 1;
+    }
+  }
+
+  if (!Headless::WriteImage(description.output_path, target.GetPicture(),
+                            description.window_size)) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace Linear {
+
+// Allocator returning memory aligned to alignment bytes, so that arrays of
+// coordinates can be loaded with aligned SIMD instructions
+template <typename T, std::size_t alignment>
+struct AlignedAllocator {
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, alignment>;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, alignment>&) {
+  }
+
+  T* allocate(std::size_t count) {
+    return static_cast<T*>(
+        ::operator new(count * sizeof(T), std::align_val_t{alignment}));
+  }
+  void deallocate(T* pointer, std::size_t) {
+    ::operator delete(pointer, std::align_val_t{alignment});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, alignment>&) const {
+    return true;
+  }
+};
+
+// Cache line alignment also covers the widest vector registers in use
+static constexpr std::size_t kCACHE_LINE_SIZE = 64;
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T, kCACHE_LINE_SIZE>>;
+
+}  // namespace Linear
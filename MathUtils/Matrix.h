@@ -27,7 +27,15 @@ constexpr Width widthFromHeight(Height elem) {
 }
 
 }  // namespace Detail
+
+// Precision of the math library and the whole rendering pipeline, selected
+// at build time. Double is kept as the reference for validation.
+#ifdef LINEAR_USE_FLOAT
+using ElemType = float;
+#else
 using ElemType = double;
+#endif
+
 using Index = int;
 
 template <Detail::Height height, Detail::Width width>
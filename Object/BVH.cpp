@@ -0,0 +1,214 @@
+#include "BVH.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace Scene {
+
+namespace {
+
+// Half the surface area, the cost of a box in the insertion heuristic
+Linear::ElemType GetHalfArea(const BoundingBox& box) {
+  Linear::Vector4 extent = box.max_corner - box.min_corner;
+  return extent(0) * extent(1) + extent(1) * extent(2) +
+         extent(2) * extent(0);
+}
+
+}  // namespace
+
+void BVH::Build(const Objects& objects) {
+  Index objects_count = objects.size();
+
+  object_boxes_.resize(objects_count);
+  object_indices_.resize(objects_count);
+  leaf_of_object_.assign(objects_count, kNONE);
+  for (Index i = 0; i < objects_count; ++i) {
+    object_boxes_[i] = objects[i].GetWorldBoundingBox();
+    object_indices_[i] = i;
+  }
+
+  nodes_.clear();
+  if (objects_count == 0) {
+    return;
+  }
+  nodes_.push_back({.begin = 0, .end = objects_count});
+  BuildNode(0);
+}
+
+void BVH::Refit(const Objects& objects, Index object_index) {
+  if (object_index < 0 || object_index >= GetObjectsCount()) {
+    return;
+  }
+  object_boxes_[object_index] = objects[object_index].GetWorldBoundingBox();
+  RefitPath(leaf_of_object_[object_index]);
+}
+
+void BVH::Insert(const Objects& objects) {
+  Index object_index = GetObjectsCount();
+  assert(object_index + 1 == Index(objects.size()) &&
+         "Only the last object may be new");
+  if (nodes_.empty()) {
+    Build(objects);
+    return;
+  }
+  BoundingBox box = objects.back().GetWorldBoundingBox();
+  object_boxes_.push_back(box);
+
+  // Descend into the child whose box grows least
+  Index leaf_index = 0;
+  Index depth = 0;
+  while (nodes_[leaf_index].first_child != kNONE) {
+    Index first_child = nodes_[leaf_index].first_child;
+    auto growth = [&](Index child) {
+      const BoundingBox& child_box = nodes_[child].box;
+      return GetHalfArea(child_box.Merge(box)) - GetHalfArea(child_box);
+    };
+    leaf_index = growth(first_child) <= growth(first_child + 1)
+                     ? first_child
+                     : first_child + 1;
+    ++depth;
+  }
+  // Splitting a full leaf puts its objects one level deeper
+  if (depth + 1 > kMAX_DEPTH) {
+    Build(objects);
+    return;
+  }
+
+  // The subtrees of the leaf and its ancestors grow by one object at the end
+  // of the leaf's range, every range after it moves by one
+  Index position = nodes_[leaf_index].end;
+  object_indices_.insert(object_indices_.begin() + position, object_index);
+  for (Node& node : nodes_) {
+    if (node.begin >= position) {
+      ++node.begin;
+      ++node.end;
+    } else if (node.end >= position) {
+      ++node.end;
+    }
+  }
+
+  leaf_of_object_.push_back(leaf_index);
+  if (nodes_[leaf_index].end - nodes_[leaf_index].begin > kMAX_LEAF_SIZE) {
+    BuildNode(leaf_index);
+  }
+  RefitPath(leaf_index);
+}
+
+Linear::Index BVH::GetObjectsCount() const {
+  return object_boxes_.size();
+}
+
+void BVH::CollectVisible(const FrustumPlanes& planes,
+                         std::vector<VisibleObject>& result) const {
+  if (nodes_.empty()) {
+    return;
+  }
+  size_t first_appended = result.size();
+
+  // Every level keeps at most one sibling on the stack
+  std::array<Index, kMAX_DEPTH + 2> stack;
+  Index stack_size = 0;
+  stack[stack_size++] = 0;
+
+  while (stack_size > 0) {
+    const Node& node = nodes_[stack[--stack_size]];
+
+    Containment containment = TestFrustum(planes, node.box);
+    if (containment == Containment::Outside) {
+      continue;
+    }
+    if (containment == Containment::Inside) {
+      for (Index i = node.begin; i < node.end; ++i) {
+        result.push_back({object_indices_[i], Containment::Inside});
+      }
+      continue;
+    }
+
+    if (node.first_child != kNONE) {
+      stack[stack_size++] = node.first_child;
+      stack[stack_size++] = node.first_child + 1;
+      continue;
+    }
+    for (Index i = node.begin; i < node.end; ++i) {
+      Index object_index = object_indices_[i];
+      Containment object_containment =
+          TestFrustum(planes, object_boxes_[object_index]);
+      if (object_containment != Containment::Outside) {
+        result.push_back({object_index, object_containment});
+      }
+    }
+  }
+
+  std::sort(result.begin() + first_appended, result.end(),
+            [](const VisibleObject& lhs, const VisibleObject& rhs) {
+              return lhs.object_index < rhs.object_index;
+            });
+}
+
+void BVH::BuildNode(Index node_index) {
+  Index begin = nodes_[node_index].begin;
+  Index end = nodes_[node_index].end;
+
+  BoundingBox box = object_boxes_[object_indices_[begin]];
+  BoundingBox centroid_box{.min_corner = box.GetCenter(),
+                           .max_corner = box.GetCenter()};
+  for (Index i = begin + 1; i < end; ++i) {
+    const BoundingBox& object_box = object_boxes_[object_indices_[i]];
+    box = box.Merge(object_box);
+    centroid_box = centroid_box.Merge(
+        {.min_corner = object_box.GetCenter(),
+         .max_corner = object_box.GetCenter()});
+  }
+  nodes_[node_index].box = box;
+
+  if (end - begin <= kMAX_LEAF_SIZE) {
+    for (Index i = begin; i < end; ++i) {
+      leaf_of_object_[object_indices_[i]] = node_index;
+    }
+    return;
+  }
+
+  // Split at the median of the centroids along the widest axis
+  Linear::Vector4 extent = centroid_box.max_corner - centroid_box.min_corner;
+  Index axis = 0;
+  for (Index i = 1; i < 3; ++i) {
+    if (extent(i) > extent(axis)) {
+      axis = i;
+    }
+  }
+  Index middle = begin + (end - begin) / 2;
+  std::nth_element(
+      object_indices_.begin() + begin, object_indices_.begin() + middle,
+      object_indices_.begin() + end, [&](Index lhs, Index rhs) {
+        return object_boxes_[lhs].GetCenter()(axis) <
+               object_boxes_[rhs].GetCenter()(axis);
+      });
+
+  Index first_child = nodes_.size();
+  nodes_[node_index].first_child = first_child;
+  nodes_.push_back({.parent = node_index, .begin = begin, .end = middle});
+  nodes_.push_back({.parent = node_index, .begin = middle, .end = end});
+  BuildNode(first_child);
+  BuildNode(first_child + 1);
+}
+
+void BVH::RefitPath(Index node_index) {
+  for (; node_index != kNONE; node_index = nodes_[node_index].parent) {
+    UpdateNodeBox(node_index);
+  }
+}
+
+void BVH::UpdateNodeBox(Index node_index) {
+  Node& node = nodes_[node_index];
+  if (node.first_child != kNONE) {
+    node.box =
+        nodes_[node.first_child].box.Merge(nodes_[node.first_child + 1].box);
+    return;
+  }
+  node.box = object_boxes_[object_indices_[node.begin]];
+  for (Index i = node.begin + 1; i < node.end; ++i) {
+    node.box = node.box.Merge(object_boxes_[object_indices_[i]]);
+  }
+}
+
+}  // namespace Scene
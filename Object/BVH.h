@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include "Bounds.h"
+#include "Object.h"
+
+namespace Scene {
+
+struct VisibleObject {
+  Linear::Index object_index;
+  Containment containment;
+};
+
+// Bounding volume hierarchy over the world-space boxes of scene objects,
+// used for hierarchical frustum culling. Built top-down by median splits;
+// moving or rotating an object only refits the boxes on its path to the
+// root and adding one only descends to a single leaf, so the tree may loosen
+// over many edits until the next Build.
+class BVH {
+  using Index = Linear::Index;
+  using Objects = std::vector<Object>;
+
+public:
+  static constexpr Index kMAX_LEAF_SIZE = 4;
+  // Insert rebuilds the whole tree rather than grow a deeper one
+  static constexpr Index kMAX_DEPTH = 32;
+
+  void Build(const Objects& objects);
+
+  // Adds objects.back(), which must be the only object the hierarchy does
+  // not cover yet, to the leaf whose box grows least
+  void Insert(const Objects& objects);
+
+  // Updates the box of objects[object_index] and its ancestors
+  void Refit(const Objects& objects, Index object_index);
+
+  // Number of objects the hierarchy was built for
+  Index GetObjectsCount() const;
+
+  // Appends objects that may be visible through the world-space planes in
+  // ascending index order. Subtrees entirely inside the frustum are
+  // appended without testing their objects one by one.
+  void CollectVisible(const FrustumPlanes& planes,
+                      std::vector<VisibleObject>& result) const;
+
+private:
+  static constexpr Index kNONE = -1;
+
+  struct Node {
+    BoundingBox box{};
+    Index parent = kNONE;
+    // The second child directly follows the first one; kNONE for leaves
+    Index first_child = kNONE;
+    // Range of the subtree's objects in object_indices_
+    Index begin;
+    Index end;
+  };
+
+  void BuildNode(Index node_index);
+  void UpdateNodeBox(Index node_index);
+  // Updates the boxes from node_index up to the root
+  void RefitPath(Index node_index);
+
+  std::vector<Node> nodes_;
+  std::vector<Index> object_indices_;
+  std::vector<Index> leaf_of_object_;
+  std::vector<BoundingBox> object_boxes_;
+};
+
+}  // namespace Scene
@@ -0,0 +1,161 @@
+#include "Bounds.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Scene {
+
+namespace {
+
+std::array<Linear::Plane, 6> ListPlanes(const FrustumPlanes& planes) {
+  return {planes.near, planes.far,  planes.up,
+          planes.down, planes.left, planes.right};
+}
+
+}  // namespace
+
+BoundingBox BoundingBox::Offset(const Vector4& offset) const {
+  return {.min_corner = min_corner + offset, .max_corner = max_corner + offset};
+}
+
+BoundingBox BoundingBox::Transform(
+    const TransformMatrix4x4& transform_matrix) const {
+  // Center moves with the matrix, extents grow by the absolute values of its
+  // linear part
+  Linear::Point4 center = Linear::Transform(transform_matrix, GetCenter());
+  Linear::Point4 half_size = (max_corner - min_corner) * Linear::ElemType(0.5);
+  Linear::Vector4 extent;
+  for (Linear::Index row = 0; row < 3; ++row) {
+    for (Linear::Index column = 0; column < 3; ++column) {
+      extent(row) += std::abs(transform_matrix(row, column)) * half_size(column);
+    }
+  }
+  return {.min_corner = center - extent, .max_corner = center + extent};
+}
+
+BoundingBox BoundingBox::Merge(const BoundingBox& other) const {
+  BoundingBox result = *this;
+  for (Linear::Index axis = 0; axis < 3; ++axis) {
+    result.min_corner(axis) =
+        std::min(result.min_corner(axis), other.min_corner(axis));
+    result.max_corner(axis) =
+        std::max(result.max_corner(axis), other.max_corner(axis));
+  }
+  return result;
+}
+
+Linear::Point4 BoundingBox::GetCenter() const {
+  return (min_corner + max_corner) * Linear::ElemType(0.5);
+}
+
+BoundingSphere BoundingSphere::Offset(const Vector4& offset) const {
+  return {.center = center + offset, .radius = radius};
+}
+
+BoundingSphere BoundingSphere::Transform(
+    const TransformMatrix4x4& transform_matrix) const {
+  // The longest image of a unit axis is the stretch of the radius for
+  // matrices with orthogonal columns, like a rotation with a scale
+  Linear::ElemType max_stretch_squared = 0;
+  for (Linear::Index column = 0; column < 3; ++column) {
+    Linear::Vector4 axis{transform_matrix(0, column),
+                         transform_matrix(1, column),
+                         transform_matrix(2, column), 0};
+    max_stretch_squared =
+        std::max(max_stretch_squared, Linear::DotProduct(axis, axis));
+  }
+  return {.center = Linear::Transform(transform_matrix, center),
+          .radius = radius * std::sqrt(max_stretch_squared)};
+}
+
+Bounds ComputeBounds(const Mesh::Coordinates& positions) {
+  using ElemType = Linear::ElemType;
+
+  if (positions.x.empty()) {
+    return {.box = {.min_corner = {0, 0, 0, 1}, .max_corner = {0, 0, 0, 1}},
+            .sphere = {.center = {0, 0, 0, 1}, .radius = 0}};
+  }
+
+  constexpr ElemType kMAX = std::numeric_limits<ElemType>::max();
+  Linear::Point4 min_corner{kMAX, kMAX, kMAX, 1};
+  Linear::Point4 max_corner{-kMAX, -kMAX, -kMAX, 1};
+  std::array<const Mesh::Array*, 3> axes{&positions.x, &positions.y,
+                                          &positions.z};
+  for (Linear::Index axis = 0; axis < 3; ++axis) {
+    auto [min_it, max_it] = std::minmax_element(axes[axis]->begin(),
+                                                axes[axis]->end());
+    min_corner(axis) = *min_it;
+    max_corner(axis) = *max_it;
+  }
+
+  Linear::Point4 center =
+      BoundingBox{.min_corner = min_corner, .max_corner = max_corner}
+          .GetCenter();
+  ElemType radius_squared = 0;
+  for (size_t i = 0; i < positions.x.size(); ++i) {
+    ElemType dx = positions.x[i] - center(0);
+    ElemType dy = positions.y[i] - center(1);
+    ElemType dz = positions.z[i] - center(2);
+    radius_squared = std::max(radius_squared, dx * dx + dy * dy + dz * dz);
+  }
+
+  return {.box = {.min_corner = min_corner, .max_corner = max_corner},
+          .sphere = {.center = center, .radius = std::sqrt(radius_squared)}};
+}
+
+FrustumPlanes OffsetFrustum(const FrustumPlanes& planes,
+                            const Linear::Vector4& offset) {
+  // A point p of the moved plane is p - offset on the original one
+  auto offset_plane = [&](const Linear::Plane& plane) {
+    Linear::Point4 origin{0, 0, 0, 1};
+    return Linear::Plane(plane.GetNormal(), plane.GetDistance(origin - offset));
+  };
+  return {.near = offset_plane(planes.near),
+          .far = offset_plane(planes.far),
+          .up = offset_plane(planes.up),
+          .down = offset_plane(planes.down),
+          .left = offset_plane(planes.left),
+          .right = offset_plane(planes.right)};
+}
+
+Containment TestFrustum(const FrustumPlanes& planes,
+                        const BoundingSphere& sphere) {
+  Containment result = Containment::Inside;
+  for (const auto& plane : ListPlanes(planes)) {
+    Linear::ElemType distance = plane.GetDistance(sphere.center);
+    if (distance < -sphere.radius) {
+      return Containment::Outside;
+    }
+    if (distance < sphere.radius) {
+      result = Containment::Intersecting;
+    }
+  }
+  return result;
+}
+
+Containment TestFrustum(const FrustumPlanes& planes, const BoundingBox& box) {
+  Containment result = Containment::Inside;
+  for (const auto& plane : ListPlanes(planes)) {
+    Linear::Point4 normal = plane.GetNormal();
+
+    // Corners farthest along and against the plane normal
+    Linear::Point4 positive_corner = box.min_corner;
+    Linear::Point4 negative_corner = box.max_corner;
+    for (Linear::Index axis = 0; axis < 3; ++axis) {
+      if (normal(axis) >= 0) {
+        std::swap(positive_corner(axis), negative_corner(axis));
+      }
+    }
+
+    if (plane.GetDistance(positive_corner) < 0) {
+      return Containment::Outside;
+    }
+    if (plane.GetDistance(negative_corner) < 0) {
+      result = Containment::Intersecting;
+    }
+  }
+  return result;
+}
+
+}  // namespace Scene
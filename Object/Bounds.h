@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include "../MathUtils/Point4.h"
+#include "Camera.h"
+#include "Mesh.h"
+
+namespace Scene {
+
+enum class Containment { Outside, Intersecting, Inside };
+
+// Axis-aligned bounding box
+struct BoundingBox {
+  using Vector4 = Linear::Vector4;
+  using TransformMatrix4x4 = Linear::TransformMatrix4x4;
+
+  BoundingBox Offset(const Vector4& offset) const;
+  // Smallest axis-aligned box containing the affinely transformed box
+  BoundingBox Transform(const TransformMatrix4x4& transform_matrix) const;
+  // Smallest box containing both
+  BoundingBox Merge(const BoundingBox& other) const;
+  Linear::Point4 GetCenter() const;
+
+  Linear::Point4 min_corner;
+  Linear::Point4 max_corner;
+};
+
+struct BoundingSphere {
+  using Vector4 = Linear::Vector4;
+  using TransformMatrix4x4 = Linear::TransformMatrix4x4;
+
+  BoundingSphere Offset(const Vector4& offset) const;
+  // Sphere containing the affinely transformed sphere
+  BoundingSphere Transform(const TransformMatrix4x4& transform_matrix) const;
+
+  Linear::Point4 center;
+  Linear::ElemType radius = 0;
+};
+
+struct Bounds {
+  BoundingBox box;
+  BoundingSphere sphere;
+};
+
+// Bounds of the points. The sphere is centered in the box, which is not
+// optimal but tight enough for culling.
+Bounds ComputeBounds(const Mesh::Coordinates& positions);
+
+// Moves the planes by offset, e.g. from camera-relative to world space
+FrustumPlanes OffsetFrustum(const FrustumPlanes& planes,
+                            const Linear::Vector4& offset);
+
+// Planes and volumes must be given in the same space. The sphere test is
+// cheaper, the box test is tighter; both are conservative, i.e. a volume may
+// be reported as intersecting while being outside near a frustum corner.
+Containment TestFrustum(const FrustumPlanes& planes,
+                        const BoundingSphere& sphere);
+Containment TestFrustum(const FrustumPlanes& planes, const BoundingBox& box);
+
+}  // namespace Scene
@@ -113,9 +113,6 @@ const FrustumPlanes Camera::GetFrustumPlanes() const {
                            camera_axes.right * (near_width / 2.0) -
                            camera_axes.up * (near_height / 2.0);
 
-  Point4 far_up_left = center_far_plane -
-                       camera_axes.right * (far_width / 2.0) +
-                       camera_axes.up * (far_height / 2.0);
   Point4 far_up_right = center_far_plane +
                         camera_axes.right * (far_width / 2.0) +
                         camera_axes.up * (far_height / 2.0);
@@ -126,16 +123,27 @@ const FrustumPlanes Camera::GetFrustumPlanes() const {
                           camera_axes.right * (far_width / 2.0) -
                           camera_axes.up * (far_height / 2.0);
 
+  // The side planes pass through the camera, so they are spanned by the
+  // directions to two near corners. Spanning them with far corners instead
+  // takes nearly parallel vectors thousands of units long, which leaves
+  // float with no precision for the normal.
+  auto side_plane = [](const Point4& first_corner,
+                       const Point4& second_corner) {
+    return Linear::Plane(
+        Linear::Normalize(Linear::CrossProduct(first_corner, second_corner)),
+        0);
+  };
+
   FrustumPlanes planes;
 
   planes.near = {near_down_left, near_down_right, near_up_right};
   planes.far = {far_up_right, far_down_right, far_down_left};
 
-  planes.up = {near_up_left, near_up_right, far_up_right};
-  planes.down = {far_down_right, near_down_right, near_down_left};
+  planes.up = side_plane(near_up_right, near_up_left);
+  planes.down = side_plane(near_down_left, near_down_right);
 
-  planes.left = {near_down_left, near_up_left, far_up_left};
-  planes.right = {far_up_right, near_up_right, near_down_right};
+  planes.left = side_plane(near_up_left, near_down_left);
+  planes.right = side_plane(near_down_right, near_up_right);
 
   return planes;
 }
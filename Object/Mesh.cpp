@@ -0,0 +1,139 @@
+#include "Mesh.h"
+#include <cassert>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace Scene {
+
+namespace {
+
+// Vertex attributes, hashed and compared bytewise so that only exactly equal
+// corners are merged
+using VertexKey = std::array<Linear::ElemType, 12>;
+
+VertexKey MakeKey(const MeshVertex& vertex) {
+  VertexKey key;
+  for (Linear::Index i = 0; i < 4; ++i) {
+    key[i] = vertex.position(i);
+    key[4 + i] = vertex.normal(i);
+    key[8 + i] = vertex.texture_coord(i);
+  }
+  return key;
+}
+
+struct VertexKeyHash {
+  size_t operator()(const VertexKey& key) const {
+    return std::hash<std::string_view>()(std::string_view(
+        reinterpret_cast<const char*>(key.data()), sizeof(VertexKey)));
+  }
+};
+
+struct VertexKeyEqual {
+  bool operator()(const VertexKey& lhs, const VertexKey& rhs) const {
+    return std::memcmp(lhs.data(), rhs.data(), sizeof(VertexKey)) == 0;
+  }
+};
+
+}  // namespace
+
+Mesh Mesh::Weld(const std::vector<TriangleData>& triangles) {
+  Mesh result;
+  result.triangles.reserve(triangles.size());
+
+  std::unordered_map<VertexKey, Index, VertexKeyHash, VertexKeyEqual>
+      vertex_indices;
+  vertex_indices.reserve(triangles.size());
+  for (const auto& triangle : triangles) {
+    MeshTriangle mesh_triangle{.material_index = triangle.material_index};
+    for (Index i = 0; i < 3; ++i) {
+      MeshVertex vertex{.position = triangle.vertices(i),
+                        .normal = triangle.normals(i),
+                        .texture_coord = triangle.texture_coords(i)};
+      auto [it, inserted] = vertex_indices.try_emplace(
+          MakeKey(vertex), result.GetVerticesCount());
+      if (inserted) {
+        result.AddVertex(vertex);
+      }
+      mesh_triangle.vertex_indices[i] = it->second;
+    }
+    result.triangles.push_back(mesh_triangle);
+  }
+
+  for (Array* array :
+       {&result.positions.x, &result.positions.y, &result.positions.z,
+        &result.normals.x, &result.normals.y, &result.normals.z,
+        &result.texture_u, &result.texture_v}) {
+    array->shrink_to_fit();
+  }
+  result.UpdateFacePlanes();
+  return result;
+}
+
+Linear::Index Mesh::GetVerticesCount() const {
+  return positions.x.size();
+}
+
+Linear::Index Mesh::GetTrianglesCount() const {
+  return triangles.size();
+}
+
+Linear::Index Mesh::AddVertex(const MeshVertex& vertex) {
+  positions.x.push_back(vertex.position(0));
+  positions.y.push_back(vertex.position(1));
+  positions.z.push_back(vertex.position(2));
+  normals.x.push_back(vertex.normal(0));
+  normals.y.push_back(vertex.normal(1));
+  normals.z.push_back(vertex.normal(2));
+  texture_u.push_back(vertex.texture_coord(0));
+  texture_v.push_back(vertex.texture_coord(1));
+  return GetVerticesCount() - 1;
+}
+
+MeshVertex Mesh::GetVertex(Index index) const {
+  assert(index >= 0 && index < GetVerticesCount() && "Invalid index");
+  return {.position = {positions.x[index], positions.y[index],
+                       positions.z[index], 1},
+          .normal = {normals.x[index], normals.y[index], normals.z[index], 0},
+          .texture_coord = {texture_u[index], texture_v[index], 0, 0}};
+}
+
+TriangleData Mesh::GetTriangle(Index index) const {
+  assert(index >= 0 && index < GetTrianglesCount() && "Invalid index");
+  const MeshTriangle& triangle = triangles[index];
+  MeshVertex vertex0 = GetVertex(triangle.vertex_indices[0]);
+  MeshVertex vertex1 = GetVertex(triangle.vertex_indices[1]);
+  MeshVertex vertex2 = GetVertex(triangle.vertex_indices[2]);
+  return {{vertex0.position, vertex1.position, vertex2.position},
+          {vertex0.normal, vertex1.normal, vertex2.normal},
+          {vertex0.texture_coord, vertex1.texture_coord,
+           vertex2.texture_coord},
+          triangle.material_index};
+}
+
+void Mesh::UpdateFacePlanes() {
+  Index triangles_count = GetTrianglesCount();
+  face_normals.x.resize(triangles_count);
+  face_normals.y.resize(triangles_count);
+  face_normals.z.resize(triangles_count);
+  face_distances.resize(triangles_count);
+
+  for (Index index = 0; index < triangles_count; ++index) {
+    const auto& [index0, index1, index2] = triangles[index].vertex_indices;
+    Linear::Point4 vertex0{positions.x[index0], positions.y[index0],
+                           positions.z[index0], 1};
+    Linear::Point4 normal =
+        Linear::Triangle{vertex0,
+                         {positions.x[index1], positions.y[index1],
+                          positions.z[index1], 1},
+                         {positions.x[index2], positions.y[index2],
+                          positions.z[index2], 1}}
+            .GetNormal();
+    face_normals.x[index] = normal(0);
+    face_normals.y[index] = normal(1);
+    face_normals.z[index] = normal(2);
+    face_distances[index] = Linear::DotProduct(normal, vertex0);
+  }
+}
+
+}  // namespace Scene
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "../MathUtils/AlignedAllocator.h"
+#include "TriangleData.h"
+
+namespace Scene {
+
+struct MeshVertex {
+  Linear::Point4 position;
+  Linear::Point4 normal;
+  Linear::Point4 texture_coord;
+};
+
+struct MeshTriangle {
+  using Index = Linear::Index;
+
+  std::array<Index, 3> vertex_indices{};
+  Index material_index = -1;
+};
+
+// Indexed triangle mesh: every distinct vertex is stored once and triangles
+// refer to their corners by index, so a vertex shared by several triangles is
+// only transformed once per frame.
+//
+// Attributes are stored as a structure of arrays, one aligned array per
+// coordinate, so that bulk passes over vertices or triangles stream through
+// memory and vectorize without gathers.
+struct Mesh {
+  using Index = Linear::Index;
+  using ElemType = Linear::ElemType;
+  using Array = Linear::AlignedVector<ElemType>;
+
+  struct Coordinates {
+    Array x;
+    Array y;
+    Array z;
+  };
+
+  // Merges corners with equal position, normal and texture coordinate
+  static Mesh Weld(const std::vector<TriangleData>& triangles);
+
+  Index GetVerticesCount() const;
+  Index GetTrianglesCount() const;
+
+  Index AddVertex(const MeshVertex& vertex);
+  MeshVertex GetVertex(Index index) const;
+
+  // Standalone copy of a triangle
+  TriangleData GetTriangle(Index index) const;
+
+  // Recomputes the face planes after triangles or positions have changed
+  void UpdateFacePlanes();
+
+  Coordinates positions;
+  Coordinates normals;
+  Array texture_u;
+  Array texture_v;
+
+  std::vector<MeshTriangle> triangles;
+
+  // Plane of every triangle: dot(face_normal, p) == face_distance for the
+  // points p of the triangle, with the unit normal facing its front side
+  Coordinates face_normals;
+  Array face_distances;
+};
+
+}  // namespace Scene
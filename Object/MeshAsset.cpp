@@ -0,0 +1,41 @@
+#include "MeshAsset.h"
+#include "Parser.h"
+
+namespace Scene {
+
+MeshAsset::MeshAsset(Mesh&& mesh, Materials&& materials)
+    : mesh_(std::move(mesh)),
+      materials_(std::move(materials)),
+      bounds_(ComputeBounds(mesh_.positions)) {
+}
+
+const Mesh& MeshAsset::GetMesh() const {
+  return mesh_;
+}
+
+const std::vector<Detail::Material>& MeshAsset::GetMaterials() const {
+  return materials_;
+}
+
+const Detail::Material* MeshAsset::GetMaterial(Index index) const {
+  if (index < 0 || index >= Index(materials_.size())) {
+    return nullptr;
+  }
+  return &materials_[index];
+}
+
+const Bounds& MeshAsset::GetBounds() const {
+  return bounds_;
+}
+
+MeshAssetPtr MeshAssetCache::Load(const std::string& path) {
+  std::weak_ptr<const MeshAsset>& cached = assets_[path];
+  if (MeshAssetPtr asset = cached.lock()) {
+    return asset;
+  }
+  MeshAssetPtr asset = ObjParser::Parse(path).GetAsset();
+  cached = asset;
+  return asset;
+}
+
+}  // namespace Scene
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Bounds.h"
+#include "Mesh.h"
+
+namespace Scene {
+
+// Geometry and materials shared by every object placed from them. Assets
+// are immutable once built and handed out through shared pointers, so any
+// number of instances and threads can read one without copying it.
+class MeshAsset {
+  using Material = Detail::Material;
+  using Materials = std::vector<Detail::Material>;
+  using Index = Linear::Index;
+
+public:
+  MeshAsset(Mesh&& mesh, Materials&& materials);
+
+  const Mesh& GetMesh() const;
+
+  const Materials& GetMaterials() const;
+  const Material* GetMaterial(Index index) const;
+
+  // Bounds in mesh coordinates
+  const Bounds& GetBounds() const;
+
+private:
+  Mesh mesh_;
+  Materials materials_;
+  Bounds bounds_;
+};
+
+using MeshAssetPtr = std::shared_ptr<const MeshAsset>;
+
+// Loads every OBJ file once: later requests for the same path share the
+// asset for as long as some object still uses it.
+class MeshAssetCache {
+public:
+  MeshAssetPtr Load(const std::string& path);
+
+private:
+  std::unordered_map<std::string, std::weak_ptr<const MeshAsset>> assets_;
+};
+
+}  // namespace Scene
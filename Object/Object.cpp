@@ -1,32 +1,78 @@
 #include "Object.h"
+#include <array>
 #include <cassert>
 #include <vector>
 #include "TriangleData.h"
 
 namespace Scene {
 
-Object::Object(TriangleDatas&& triangles, Materials&& materials)
-    : triangles_(std::move(triangles)), materials_(std::move(materials)) {
+namespace {
+
+// Gram-Schmidt over the columns of the upper 3x3 block, so that rotations
+// composed over and over do not drift into shear or scale
+void Orthonormalize(Linear::TransformMatrix4x4& rotation) {
+  std::array<Linear::Point4, 3> axes;
+  for (Linear::Index column = 0; column < 3; ++column) {
+    axes[column] = {rotation(0, column), rotation(1, column),
+                    rotation(2, column), 0};
+  }
+  axes[0] = Linear::Normalize(axes[0]);
+  axes[1] = Linear::Normalize(
+      axes[1] - axes[0] * Linear::DotProduct(axes[0], axes[1]));
+  axes[2] = Linear::CrossProduct(axes[0], axes[1]);
+
+  rotation = Linear::TransformMatrix4x4::Eye();
+  for (Linear::Index column = 0; column < 3; ++column) {
+    for (Linear::Index row = 0; row < 3; ++row) {
+      rotation(row, column) = axes[column](row);
+    }
+  }
+}
+
+}  // namespace
+
+Object::Object() : Object(Mesh{}, {}) {
+}
+
+Object::Object(MeshAssetPtr asset) : asset_(std::move(asset)) {
+  assert(asset_ && "Object needs an asset");
+}
+
+Object::Object(const TriangleDatas& triangles, Materials&& materials)
+    : Object(Mesh::Weld(triangles), std::move(materials)) {
+}
+
+Object::Object(Mesh&& mesh, Materials&& materials)
+    : asset_(std::make_shared<const MeshAsset>(std::move(mesh),
+                                               std::move(materials))) {
+}
+
+const MeshAssetPtr& Object::GetAsset() const {
+  return asset_;
 }
 
 Linear::Index Object::GetTrianglesCount() const {
-  return triangles_.size();
+  return asset_->GetMesh().GetTrianglesCount();
+}
+
+Linear::Index Object::GetVerticesCount() const {
+  return asset_->GetMesh().GetVerticesCount();
+}
+
+TriangleData Object::operator()(Linear::Index index) const {
+  return asset_->GetMesh().GetTriangle(index);
 }
 
-TriangleData& Object::operator()(Linear::Index index) {
-  assert(index >= 0 && index < triangles_.size() && "Invalid index");
-  return triangles_[index];
+const Mesh& Object::GetMesh() const {
+  return asset_->GetMesh();
 }
 
 const std::vector<Detail::Material>& Object::GetMaterials() const {
-  return materials_;
+  return asset_->GetMaterials();
 }
 
 const Detail::Material* Object::GetMaterial(Index index) const {
-  if (index < 0 || index >= materials_.size()) {
-    return nullptr;
-  }
-  return &materials_[index];
+  return asset_->GetMaterial(index);
 }
 
 Linear::Point4 Object::GetPosition() const {
@@ -37,4 +83,56 @@ void Object::SetPosition(const Linear::Point4& new_position) {
   position_ = new_position;
 }
 
+const Linear::TransformMatrix4x4& Object::GetRotation() const {
+  return rotation_;
+}
+
+void Object::SetRotation(const TransformMatrix4x4& new_rotation) {
+  rotation_ = new_rotation;
+  Orthonormalize(rotation_);
+}
+
+void Object::Rotate(const TransformMatrix4x4& rotation) {
+  SetRotation(rotation * rotation_);
+}
+
+Linear::ElemType Object::GetScale() const {
+  return scale_;
+}
+
+void Object::SetScale(ElemType new_scale) {
+  assert(new_scale > 0 && "Scale must be positive");
+  scale_ = new_scale;
+}
+
+Linear::TransformMatrix4x4 Object::GetModelMatrix() const {
+  TransformMatrix4x4 result = rotation_ * scale_;
+  for (Index row = 0; row < 3; ++row) {
+    result(row, 3) = position_(row);
+  }
+  result(3, 3) = 1;
+  return result;
+}
+
+Linear::Point4 Object::ToModelSpace(const Point4& world_point) const {
+  // The inverse of an orthonormal rotation is its transpose
+  Point4 result = Linear::Transform(rotation_.Transpose(),
+                                    world_point - position_) *
+                  (1 / scale_);
+  result(3) = 1;
+  return result;
+}
+
+const Bounds& Object::GetBounds() const {
+  return asset_->GetBounds();
+}
+
+BoundingBox Object::GetWorldBoundingBox() const {
+  return GetBounds().box.Transform(GetModelMatrix());
+}
+
+BoundingSphere Object::GetWorldBoundingSphere() const {
+  return GetBounds().sphere.Transform(GetModelMatrix());
+}
+
 }  // namespace Scene
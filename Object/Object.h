@@ -1,24 +1,41 @@
 #pragma once
 
 #include <vector>
+#include "Bounds.h"
+#include "Mesh.h"
+#include "MeshAsset.h"
 #include "TriangleData.h"
 
 namespace Scene {
 
+// Placement of a mesh asset in the scene. Objects only hold a reference to
+// their asset, so copying one or placing the same asset many times is cheap.
 class Object {
   using TriangleDatas = std::vector<TriangleData>;
   using Material = Detail::Material;
   using Materials = std::vector<Detail::Material>;
+  using ElemType = Linear::ElemType;
   using Point4 = Linear::Point4;
   using Index = Linear::Index;
+  using TransformMatrix4x4 = Linear::TransformMatrix4x4;
 
 public:
-  Object() = default;
-  Object(TriangleDatas&& triangles, Materials&& materials);
+  // Instance of an empty mesh
+  Object();
+  explicit Object(MeshAssetPtr asset);
+  // Welds the triangles into a new asset with an indexed mesh
+  Object(const TriangleDatas& triangles, Materials&& materials);
+  Object(Mesh&& mesh, Materials&& materials);
+
+  const MeshAssetPtr& GetAsset() const;
 
   Index GetTrianglesCount() const;
+  Index GetVerticesCount() const;
+
+  // Mesh-space copy of a triangle of the asset
+  TriangleData operator()(Index index) const;
 
-  TriangleData& operator()(Index index);
+  const Mesh& GetMesh() const;
 
   const Materials& GetMaterials() const;
   const Material* GetMaterial(Index index) const;
@@ -26,12 +43,35 @@ public:
   Point4 GetPosition() const;
   void SetPosition(const Point4& new_position);
 
+  // Orientation around the object's origin. Only the upper 3x3 block is used
+  // and it is kept orthonormal.
+  const TransformMatrix4x4& GetRotation() const;
+  void SetRotation(const TransformMatrix4x4& new_rotation);
+  // Applies rotation on top of the current orientation
+  void Rotate(const TransformMatrix4x4& rotation);
+
+  // Uniform and positive, so that normals only need the rotation
+  ElemType GetScale() const;
+  void SetScale(ElemType new_scale);
+
+  // Mesh coordinates to world space: scale, then rotation, then position
+  TransformMatrix4x4 GetModelMatrix() const;
+  // World-space point in mesh coordinates
+  Point4 ToModelSpace(const Point4& world_point) const;
+
+  // Bounds in mesh coordinates
+  const Bounds& GetBounds() const;
+  // Bounds in world space
+  BoundingBox GetWorldBoundingBox() const;
+  BoundingSphere GetWorldBoundingSphere() const;
+
 private:
   static inline const Point4 kDEFAULT_POSITION = {0, 0, 0, 1};
 
   Point4 position_ = kDEFAULT_POSITION;
-  TriangleDatas triangles_;
-  Materials materials_;
+  TransformMatrix4x4 rotation_ = TransformMatrix4x4::Eye();
+  ElemType scale_ = 1;
+  MeshAssetPtr asset_;
 };
 
 }  // namespace Scene
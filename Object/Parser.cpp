@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "../Profiling/Trace.h"
 #include "Object.h"
 #include "stb_image.h"
 
@@ -65,6 +66,7 @@ static void parse_face_token(const std::string& token, int& vertex_idx,
 }
 
 static Detail::Texture load_texture_file(const std::string& filepath) {
+  TRACE_SCOPE("load_texture_file");
   int width, height, channels;
   unsigned char* data =
       stbi_load(filepath.c_str(), &width, &height, &channels, 4);
@@ -85,6 +87,7 @@ static Detail::Texture load_texture_file(const std::string& filepath) {
 
 static std::unordered_map<std::string, Detail::Material> parse_material_file(
     const std::string& mtl_path, const std::string& base_dir) {
+  TRACE_SCOPE("parse_material_file");
   std::cerr << "[DEBUG] parse_material_file: mtl_path=\"" << mtl_path
             << "\", base_dir=\"" << base_dir << "\"\n";
   std::unordered_map<std::string, Detail::Material> material_map;
@@ -135,10 +138,11 @@ static std::unordered_map<std::string, Detail::Material> parse_material_file(
 }
 
 Object ObjParser::Parse(const std::string& filepath) {
+  TRACE_SCOPE("ObjParser::Parse");
   std::ifstream in(filepath);
   if (!in) {
     std::cerr << "Cannot open OBJ: " << filepath << "\n";
-    return Object({}, {});
+    return Object(Mesh{}, {});
   }
   // базовая папка
   std::string base = filepath.substr(0, filepath.find_last_of("/\\") + 1);
@@ -184,7 +188,7 @@ Object ObjParser::Parse(const std::string& filepath) {
         parse_face_token(tokens[i], vi[1], ti[1], ni[1]);
         parse_face_token(tokens[i + 1], vi[2], ti[2], ni[2]);
 
-        Linear::Triangle tri(vertices[vi[1]], vertices[vi[2]], vertices[vi[0]]);
+        Linear::Triangle tri(vertices[vi[0]], vertices[vi[1]], vertices[vi[2]]);
         Linear::Triangle norm_tri;
         if (!normals.empty() && ni[0] >= 0) {
           norm_tri(0) = normals[ni[0]];
@@ -220,7 +224,8 @@ Object ObjParser::Parse(const std::string& filepath) {
     }
   }
 
-  return Object(std::move(tris), std::move(mat_list));
+  // Corners shared between faces are welded into single vertices here
+  return Object(tris, std::move(mat_list));
 }
 
 }  // namespace Scene
@@ -0,0 +1,79 @@
+#include "SceneSnapshot.h"
+#include <cassert>
+
+namespace Scene {
+
+SceneSnapshot::SceneSnapshot()
+    : objects_(std::make_shared<const Objects>()),
+      bvh_(std::make_shared<const BVH>()),
+      lights_(std::make_shared<const Lights>()) {
+}
+
+const std::vector<Object>& SceneSnapshot::GetObjects() const {
+  return *objects_;
+}
+
+Linear::Index SceneSnapshot::GetObjectsCount() const {
+  return objects_->size();
+}
+
+const Object& SceneSnapshot::GetObject(Index index) const {
+  assert(index >= 0 && index < GetObjectsCount() && "Index out of range");
+  return (*objects_)[index];
+}
+
+const BVH& SceneSnapshot::GetBVH() const {
+  return *bvh_;
+}
+
+const Camera& SceneSnapshot::GetCamera() const {
+  return camera_;
+}
+
+const Detail::Lights& SceneSnapshot::GetLights() const {
+  return *lights_;
+}
+
+SceneSnapshot SceneSnapshot::WithObjectAdded(const Object& object) const {
+  auto objects = std::make_shared<Objects>(*objects_);
+  objects->push_back(object);
+  auto bvh = std::make_shared<BVH>(*bvh_);
+  bvh->Insert(*objects);
+
+  SceneSnapshot result = *this;
+  result.objects_ = std::move(objects);
+  result.bvh_ = std::move(bvh);
+  return result;
+}
+
+SceneSnapshot SceneSnapshot::WithObject(Index index,
+                                        const Object& object) const {
+  assert(index >= 0 && index < GetObjectsCount() && "Index out of range");
+  // Instances are small, their meshes stay shared with the old version
+  auto objects = std::make_shared<Objects>(*objects_);
+  (*objects)[index] = object;
+  auto bvh = std::make_shared<BVH>(*bvh_);
+  bvh->Refit(*objects, index);
+
+  SceneSnapshot result = *this;
+  result.objects_ = std::move(objects);
+  result.bvh_ = std::move(bvh);
+  return result;
+}
+
+SceneSnapshot SceneSnapshot::WithCamera(const Camera& camera) const {
+  SceneSnapshot result = *this;
+  result.camera_ = camera;
+  return result;
+}
+
+SceneSnapshot SceneSnapshot::WithLightAdded(const Light& light) const {
+  auto lights = std::make_shared<Lights>(*lights_);
+  lights->push_back(light);
+
+  SceneSnapshot result = *this;
+  result.lights_ = std::move(lights);
+  return result;
+}
+
+}  // namespace Scene
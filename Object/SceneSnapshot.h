@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "../Detail/Palette.h"
+#include "BVH.h"
+#include "Camera.h"
+#include "Object.h"
+
+namespace Scene {
+
+// One immutable version of the scene. Edits build a new version that shares
+// every part they do not touch: moving the camera shares the objects and
+// their hierarchy, moving an object shares the lights, and the geometry of
+// the objects is always shared through their mesh assets. A reader holding
+// a version may keep using it while newer ones are published.
+//
+// The renderer takes the objects as one contiguous vector, so adding or
+// editing an object copies the instance vector and the hierarchy, which is
+// linear in the number of objects but never touches their meshes.
+class SceneSnapshot {
+  using Index = Linear::Index;
+  using Objects = std::vector<Object>;
+  using Light = Detail::Light;
+  using Lights = Detail::Lights;
+
+public:
+  // Empty scene seen from the default camera
+  SceneSnapshot();
+
+  const Objects& GetObjects() const;
+  Index GetObjectsCount() const;
+  const Object& GetObject(Index index) const;
+
+  // Hierarchy over the objects, extended when objects are added and refit
+  // when they move
+  const BVH& GetBVH() const;
+
+  const Camera& GetCamera() const;
+  const Lights& GetLights() const;
+
+  SceneSnapshot WithObjectAdded(const Object& object) const;
+  SceneSnapshot WithObject(Index index, const Object& object) const;
+  SceneSnapshot WithCamera(const Camera& camera) const;
+  SceneSnapshot WithLightAdded(const Light& light) const;
+
+private:
+  std::shared_ptr<const Objects> objects_;
+  std::shared_ptr<const BVH> bvh_;
+  std::shared_ptr<const Lights> lights_;
+  Camera camera_;
+};
+
+using SceneSnapshotPtr = std::shared_ptr<const SceneSnapshot>;
+
+}  // namespace Scene
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations of the whole process, made through any form of the
+// global operator new. Counting replaces the global allocation functions, so
+// it is only built into tests and benchmarks: link the AllocationHook object
+// library to get it. Calls from programs without the hook fail to link.
+
+namespace Profiling {
+
+// Allocations since the start of the process, on all threads
+uint64_t GetAllocationsCount();
+
+// Allocations made during its lifetime, on all threads
+class ScopedAllocationCounter {
+public:
+  ScopedAllocationCounter() : begin_(GetAllocationsCount()) {
+  }
+
+  uint64_t GetCount() const {
+    return GetAllocationsCount() - begin_;
+  }
+
+private:
+  uint64_t begin_;
+};
+
+}  // namespace Profiling
@@ -0,0 +1,139 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+// Replacements of the global allocation functions that count every call.
+// The delete forms only need to match the allocation below.
+
+namespace Profiling {
+
+namespace {
+
+std::atomic<uint64_t> allocations_count = 0;
+
+void* Allocate(std::size_t size) {
+  allocations_count.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* AllocateAligned(std::size_t size, std::align_val_t alignment) {
+  allocations_count.fetch_add(1, std::memory_order_relaxed);
+  std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+  return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+  // aligned_alloc wants a size that is a multiple of the alignment
+  std::size_t aligned_size = (size + align - 1) / align * align;
+  return std::aligned_alloc(align, aligned_size == 0 ? align : aligned_size);
+#endif
+}
+
+void FreeAligned(void* pointer) {
+#ifdef _MSC_VER
+  _aligned_free(pointer);
+#else
+  std::free(pointer);
+#endif
+}
+
+}  // namespace
+
+uint64_t GetAllocationsCount() {
+  return allocations_count.load(std::memory_order_relaxed);
+}
+
+}  // namespace Profiling
+
+void* operator new(std::size_t size) {
+  if (void* pointer = Profiling::Allocate(size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return Profiling::Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return Profiling::Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  if (void* pointer = Profiling::AllocateAligned(size, alignment)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return Profiling::AllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return Profiling::AllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+  Profiling::FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+  Profiling::FreeAligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+  Profiling::FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+  Profiling::FreeAligned(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+  Profiling::FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+  Profiling::FreeAligned(pointer);
+}
@@ -0,0 +1,141 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace Profiling {
+
+ThreadPerfCounters& ThreadPerfCounters::Get() {
+  thread_local ThreadPerfCounters counters;
+  return counters;
+}
+
+bool ThreadPerfCounters::IsAvailable() const {
+  return group_fd_ != kCLOSED;
+}
+
+bool ThreadPerfCounters::IsOpened(PerfCounterValues::Counter counter) const {
+  return fds_[counter] != kCLOSED;
+}
+
+#ifdef __linux__
+
+namespace {
+
+struct CounterConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t MakeCacheConfig(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// In the order of PerfCounterValues::Counter
+constexpr std::array<CounterConfig, PerfCounterValues::kCOUNTERS_COUNT>
+    kCOUNTER_CONFIGS{{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, MakeCacheConfig(PERF_COUNT_HW_CACHE_L1D)},
+        {PERF_TYPE_HW_CACHE, MakeCacheConfig(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    }};
+
+int OpenCounter(const CounterConfig& counter_config, int group_fd) {
+  perf_event_attr attributes;
+  std::memset(&attributes, 0, sizeof(attributes));
+  attributes.size = sizeof(attributes);
+  attributes.type = counter_config.type;
+  attributes.config = counter_config.config;
+  attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // User space only, which unprivileged processes may count by default
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  // The calling thread on any CPU
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attributes, 0, -1, group_fd, 0));
+}
+
+}  // namespace
+
+ThreadPerfCounters::ThreadPerfCounters() {
+  fds_.fill(kCLOSED);
+  for (int i = 0; i < PerfCounterValues::kCOUNTERS_COUNT; ++i) {
+    int fd = OpenCounter(kCOUNTER_CONFIGS[i], group_fd_);
+    if (fd < 0) {
+      continue;
+    }
+    if (ioctl(fd, PERF_EVENT_IOC_ID, &ids_[i]) != 0) {
+      close(fd);
+      continue;
+    }
+    fds_[i] = fd;
+    if (group_fd_ == kCLOSED) {
+      group_fd_ = fd;
+    }
+  }
+}
+
+ThreadPerfCounters::~ThreadPerfCounters() {
+  for (int fd : fds_) {
+    if (fd != kCLOSED) {
+      close(fd);
+    }
+  }
+}
+
+PerfCounterValues ThreadPerfCounters::Read() const {
+  PerfCounterValues result;
+  if (group_fd_ == kCLOSED) {
+    return result;
+  }
+
+  struct ReadFormat {
+    uint64_t counters_count;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    struct {
+      uint64_t value;
+      uint64_t id;
+    } values[PerfCounterValues::kCOUNTERS_COUNT];
+  } data;
+  if (read(group_fd_, &data, sizeof(data)) <= 0 || data.time_running == 0) {
+    return result;
+  }
+
+  double scale = static_cast<double>(data.time_enabled) / data.time_running;
+  for (uint64_t i = 0; i < data.counters_count; ++i) {
+    for (int counter = 0; counter < PerfCounterValues::kCOUNTERS_COUNT;
+         ++counter) {
+      if (fds_[counter] != kCLOSED && ids_[counter] == data.values[i].id) {
+        result.counts[counter] =
+            static_cast<uint64_t>(data.values[i].value * scale);
+      }
+    }
+  }
+  return result;
+}
+
+#else
+
+ThreadPerfCounters::ThreadPerfCounters() {
+  fds_.fill(kCLOSED);
+}
+
+ThreadPerfCounters::~ThreadPerfCounters() = default;
+
+PerfCounterValues ThreadPerfCounters::Read() const {
+  return {};
+}
+
+#endif
+
+}  // namespace Profiling
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Hardware performance counters of a thread, read through perf_event_open on
+// Linux. Elsewhere, and where the kernel refuses a counter for lack of
+// permission (see /proc/sys/kernel/perf_event_paranoid) or support, the
+// counter stays closed and reads as zero.
+
+namespace Profiling {
+
+struct PerfCounterValues {
+  enum Counter : int {
+    kCYCLES,
+    kINSTRUCTIONS,
+    // Data reads missing the first level cache
+    kL1D_MISSES,
+    // Misses of the last level cache
+    kLLC_MISSES,
+    kBRANCH_MISSES,
+    kCOUNTERS_COUNT
+  };
+
+  static constexpr std::array<const char*, kCOUNTERS_COUNT> kCOUNTER_NAMES{
+      "cycles", "instructions", "L1d misses", "LLC misses", "branch misses"};
+
+  PerfCounterValues& operator+=(const PerfCounterValues& other) {
+    for (int i = 0; i < kCOUNTERS_COUNT; ++i) {
+      counts[i] += other.counts[i];
+    }
+    return *this;
+  }
+
+  friend PerfCounterValues operator-(PerfCounterValues lhs,
+                                     const PerfCounterValues& rhs) {
+    // Scaled counts may step back a little when the scale changes
+    for (int i = 0; i < kCOUNTERS_COUNT; ++i) {
+      lhs.counts[i] =
+          lhs.counts[i] > rhs.counts[i] ? lhs.counts[i] - rhs.counts[i] : 0;
+    }
+    return lhs;
+  }
+
+  std::array<uint64_t, kCOUNTERS_COUNT> counts{};
+};
+
+// Counters of one thread, opened as a group so that they are read in one
+// system call and cover the same span.
+class ThreadPerfCounters {
+public:
+  // Counters of the calling thread, opened on the first call from it. They
+  // may only be read by that thread.
+  static ThreadPerfCounters& Get();
+
+  ~ThreadPerfCounters();
+
+  ThreadPerfCounters(const ThreadPerfCounters&) = delete;
+  ThreadPerfCounters& operator=(const ThreadPerfCounters&) = delete;
+
+  // Whether any counter could be opened
+  bool IsAvailable() const;
+  bool IsOpened(PerfCounterValues::Counter counter) const;
+
+  // Events since the counters were opened, scaled up when the kernel had to
+  // share the hardware with other groups
+  PerfCounterValues Read() const;
+
+private:
+  ThreadPerfCounters();
+
+  static constexpr int kCLOSED = -1;
+
+  std::array<int, PerfCounterValues::kCOUNTERS_COUNT> fds_;
+  std::array<uint64_t, PerfCounterValues::kCOUNTERS_COUNT> ids_{};
+  // First opened counter, read on behalf of the whole group
+  int group_fd_ = kCLOSED;
+};
+
+}  // namespace Profiling
@@ -0,0 +1,187 @@
+#include "Trace.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+
+namespace Profiling {
+
+namespace {
+
+struct Event {
+  const char* name;
+  const char* argument_name;
+  int64_t argument;
+  int64_t begin;
+  int64_t end;
+};
+
+// Events are stored in fixed chunks, so that recording never moves the
+// events a writer may be reading
+struct EventChunk {
+  static constexpr size_t kCAPACITY = 1024;
+
+  std::array<Event, kCAPACITY> events;
+  std::atomic<EventChunk*> next = nullptr;
+};
+
+// Written only by its thread. Buffers are never freed, as threads may exit
+// before the trace is written, and a new session reuses their chunks.
+struct ThreadBuffer {
+  EventChunk first_chunk;
+  // Chunk the next event goes to
+  EventChunk* last_chunk = &first_chunk;
+  // Events of the session recorded so far
+  std::atomic<size_t> size = 0;
+  std::atomic<uint64_t> session = 0;
+  std::atomic<const char*> name = nullptr;
+  int64_t thread_id = 0;
+  ThreadBuffer* next_buffer = nullptr;
+};
+
+std::atomic<bool> tracing = false;
+std::atomic<ThreadBuffer*> buffers_head = nullptr;
+std::atomic<int64_t> threads_count = 0;
+std::atomic<uint64_t> current_session = 0;
+std::atomic<int64_t> session_begin = 0;
+
+// Buffers are only made for threads that record, named or not
+thread_local ThreadBuffer* thread_buffer = nullptr;
+thread_local const char* thread_name = nullptr;
+
+ThreadBuffer* RegisterThreadBuffer() {
+  ThreadBuffer* buffer = new ThreadBuffer;
+  buffer->name.store(thread_name, std::memory_order_relaxed);
+  buffer->thread_id = threads_count.fetch_add(1) + 1;
+  buffer->next_buffer = buffers_head.load(std::memory_order_relaxed);
+  while (!buffers_head.compare_exchange_weak(buffer->next_buffer, buffer,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+  }
+  return buffer;
+}
+
+ThreadBuffer& GetThreadBuffer() {
+  if (!thread_buffer) {
+    thread_buffer = RegisterThreadBuffer();
+  }
+  return *thread_buffer;
+}
+
+}  // namespace
+
+void StartTracing() {
+  session_begin.store(TraceScope::Now(), std::memory_order_relaxed);
+  current_session.fetch_add(1, std::memory_order_release);
+  tracing.store(true, std::memory_order_release);
+}
+
+void StopTracing() {
+  tracing.store(false, std::memory_order_release);
+}
+
+bool IsTracing() {
+  return tracing.load(std::memory_order_relaxed);
+}
+
+void SetThreadName(const char* name) {
+  thread_name = name;
+  if (thread_buffer) {
+    thread_buffer->name.store(name, std::memory_order_release);
+  }
+}
+
+int64_t TraceScope::Now() {
+  using Clock = std::chrono::steady_clock;
+  static const Clock::time_point kEPOCH = Clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              kEPOCH)
+      .count();
+}
+
+void TraceScope::Record(const char* name, const char* argument_name,
+                        int64_t argument, int64_t begin, int64_t end) {
+  // Scopes still open when the session changed do not belong to it
+  if (!IsTracing() || begin < session_begin.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  ThreadBuffer& buffer = GetThreadBuffer();
+  uint64_t session = current_session.load(std::memory_order_acquire);
+  if (buffer.session.load(std::memory_order_relaxed) != session) {
+    buffer.size.store(0, std::memory_order_relaxed);
+    buffer.last_chunk = &buffer.first_chunk;
+    buffer.session.store(session, std::memory_order_release);
+  }
+
+  size_t size = buffer.size.load(std::memory_order_relaxed);
+  size_t index = size % EventChunk::kCAPACITY;
+  if (size != 0 && index == 0) {
+    // Chunks of earlier sessions are reused
+    EventChunk* next =
+        buffer.last_chunk->next.load(std::memory_order_relaxed);
+    if (!next) {
+      next = new EventChunk;
+      buffer.last_chunk->next.store(next, std::memory_order_release);
+    }
+    buffer.last_chunk = next;
+  }
+  buffer.last_chunk->events[index] = {name, argument_name, argument, begin,
+                                      end};
+  // Publishes the event to the writer
+  buffer.size.store(size + 1, std::memory_order_release);
+}
+
+bool WriteTrace(const std::string& path) {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+  uint64_t session = current_session.load(std::memory_order_acquire);
+  int64_t begin = session_begin.load(std::memory_order_relaxed);
+  // Timestamps are in microseconds from the start of the session
+  auto microseconds = [](int64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1000;
+  };
+
+  out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  const char* separator = "\n";
+  out.setf(std::ios::fixed);
+  out.precision(3);
+  for (const ThreadBuffer* buffer =
+           buffers_head.load(std::memory_order_acquire);
+       buffer; buffer = buffer->next_buffer) {
+    if (const char* name = buffer->name.load(std::memory_order_acquire)) {
+      out << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", "
+          << "\"pid\": 1, \"tid\": " << buffer->thread_id
+          << ", \"args\": {\"name\": \"" << name << "\"}}";
+      separator = ",\n";
+    }
+    if (buffer->session.load(std::memory_order_acquire) != session) {
+      continue;
+    }
+
+    size_t size = buffer->size.load(std::memory_order_acquire);
+    const EventChunk* chunk = &buffer->first_chunk;
+    for (size_t i = 0; i < size; ++i) {
+      if (i != 0 && i % EventChunk::kCAPACITY == 0) {
+        chunk = chunk->next.load(std::memory_order_acquire);
+      }
+      const Event& event = chunk->events[i % EventChunk::kCAPACITY];
+      out << separator << "{\"name\": \"" << event.name
+          << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->thread_id
+          << ", \"ts\": " << microseconds(event.begin - begin)
+          << ", \"dur\": " << microseconds(event.end - event.begin);
+      if (event.argument_name) {
+        out << ", \"args\": {\"" << event.argument_name
+            << "\": " << event.argument << "}";
+      }
+      out << "}";
+      separator = ",\n";
+    }
+  }
+  out << "\n]}\n";
+  return static_cast<bool>(out);
+}
+
+}  // namespace Profiling
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Timeline of scoped events in the Chrome trace-event format, viewable in
+// chrome://tracing or Perfetto. Every thread records into its own buffer
+// without locks, so tracing costs a clock read and a store per event and
+// does not serialize the tile workers. Recording is off until StartTracing.
+
+namespace Profiling {
+
+#ifdef PROFILING_TRACE
+inline constexpr bool kTRACING_ENABLED = true;
+#else
+inline constexpr bool kTRACING_ENABLED = false;
+#endif
+
+// Starts a session, dropping events recorded by the previous one
+void StartTracing();
+
+// Ends the session. Events of scopes still open are dropped.
+void StopTracing();
+
+bool IsTracing();
+
+// Writes the events of the last or the running session as trace-event JSON.
+// Called by the thread that starts the sessions. Returns false if the file
+// could not be written.
+bool WriteTrace(const std::string& path);
+
+// Names the calling thread in the timeline. name must outlive the tracing.
+void SetThreadName(const char* name);
+
+// Records the time from its construction to its destruction as one event,
+// if tracing was on when it was constructed. name and argument_name must be
+// string literals or otherwise outlive the tracing.
+class TraceScope {
+public:
+  explicit TraceScope(const char* name, const char* argument_name = nullptr,
+                      int64_t argument = 0)
+      : name_(name), argument_name_(argument_name), argument_(argument) {
+    if (IsTracing()) {
+      begin_ = Now();
+    }
+  }
+
+  ~TraceScope() {
+    if (begin_ != kNOT_RECORDING) {
+      Record(name_, argument_name_, argument_, begin_, Now());
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+  // Nanoseconds since the start of the process
+  static int64_t Now();
+
+private:
+  static constexpr int64_t kNOT_RECORDING = -1;
+
+  static void Record(const char* name, const char* argument_name,
+                     int64_t argument, int64_t begin, int64_t end);
+
+  const char* name_;
+  const char* argument_name_;
+  int64_t argument_;
+  int64_t begin_ = kNOT_RECORDING;
+};
+
+}  // namespace Profiling
+
+#define PROFILING_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define PROFILING_CONCAT(lhs, rhs) PROFILING_CONCAT_IMPL(lhs, rhs)
+
+// Trace markers compile to nothing without PROFILING_TRACE
+#ifdef PROFILING_TRACE
+#define TRACE_SCOPE(name) \
+  ::Profiling::TraceScope PROFILING_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, argument_name, argument)             \
+  ::Profiling::TraceScope PROFILING_CONCAT(trace_scope_, __LINE__)( \
+      name, argument_name, argument)
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_SCOPE_ARG(name, argument_name, argument)
+#endif
@@ -0,0 +1,132 @@
+#include "Clipper.h"
+
+namespace Rendering {
+
+Clipper::ClipResult Clipper::Classify(const Triangle& clip_vertices) const {
+  std::array<unsigned, 3> outcodes{ComputeOutcode(clip_vertices(0)),
+                                   ComputeOutcode(clip_vertices(1)),
+                                   ComputeOutcode(clip_vertices(2))};
+
+  if (outcodes[0] & outcodes[1] & outcodes[2] & kVIEW_VOLUME_PLANES) {
+    return ClipResult::Outside;
+  }
+  if ((outcodes[0] | outcodes[1] | outcodes[2]) & kCLIPPING_PLANES) {
+    return ClipResult::Clipped;
+  }
+  return ClipResult::Inside;
+}
+
+Clipper::ClipResult Clipper::Clip(const TriangleData& triangle,
+                                  const Triangle& clip_vertices,
+                                  Polygon& polygon) const {
+  ClipResult classification = Classify(clip_vertices);
+  if (classification != ClipResult::Clipped) {
+    return classification;
+  }
+  unsigned crossed_planes = (ComputeOutcode(clip_vertices(0)) |
+                             ComputeOutcode(clip_vertices(1)) |
+                             ComputeOutcode(clip_vertices(2))) &
+                            kCLIPPING_PLANES;
+
+  polygon.size = 3;
+  for (Index i = 0; i < 3; ++i) {
+    polygon.vertices[i] = {.clip_position = clip_vertices(i),
+                           .position = triangle.vertices(i),
+                           .normal = triangle.normals(i),
+                           .texture_coord = triangle.texture_coords(i)};
+  }
+
+  for (unsigned plane = kNEAR; plane <= kGUARD_TOP; plane <<= 1) {
+    if (crossed_planes & plane) {
+      ClipPolygon(static_cast<Outcode>(plane), polygon);
+      if (polygon.size < 3) {
+        return ClipResult::Outside;
+      }
+    }
+  }
+  return ClipResult::Clipped;
+}
+
+unsigned Clipper::ComputeOutcode(const Point4& clip_position) {
+  ElemType x = clip_position(0);
+  ElemType y = clip_position(1);
+  ElemType z = clip_position(2);
+  ElemType w = clip_position(3);
+  ElemType guard_w = kGUARD_BAND * w;
+
+  unsigned outcode = 0;
+  auto set_if = [&outcode](bool outside, Outcode plane) {
+    if (outside) {
+      outcode |= plane;
+    }
+  };
+  set_if(x < -w, kLEFT);
+  set_if(x > w, kRIGHT);
+  set_if(y < -w, kBOTTOM);
+  set_if(y > w, kTOP);
+  set_if(z < 0, kNEAR);
+  set_if(z > w, kFAR);
+  set_if(x < -guard_w, kGUARD_LEFT);
+  set_if(x > guard_w, kGUARD_RIGHT);
+  set_if(y < -guard_w, kGUARD_BOTTOM);
+  set_if(y > guard_w, kGUARD_TOP);
+  return outcode;
+}
+
+Linear::ElemType Clipper::GetPlaneDistance(Outcode plane,
+                                           const Point4& clip_position) {
+  ElemType x = clip_position(0);
+  ElemType y = clip_position(1);
+  ElemType z = clip_position(2);
+  ElemType w = clip_position(3);
+
+  switch (plane) {
+    case kNEAR:
+      return z;
+    case kFAR:
+      return w - z;
+    case kGUARD_LEFT:
+      return x + kGUARD_BAND * w;
+    case kGUARD_RIGHT:
+      return kGUARD_BAND * w - x;
+    case kGUARD_BOTTOM:
+      return y + kGUARD_BAND * w;
+    case kGUARD_TOP:
+      return kGUARD_BAND * w - y;
+    default:
+      return 0;
+  }
+}
+
+void Clipper::ClipPolygon(Outcode plane, Polygon& polygon) {
+  // Sutherland-Hodgman against a single plane. Clip space is an affine image
+  // of view space, so the same parameter interpolates every attribute.
+  auto interpolate = [](const Point4& a, const Point4& b, ElemType t) {
+    return a + (b - a) * t;
+  };
+
+  Polygon result;
+  for (Index i = 0; i < polygon.size; ++i) {
+    const Vertex& current = polygon.vertices[i];
+    const Vertex& next = polygon.vertices[(i + 1) % polygon.size];
+    ElemType current_distance = GetPlaneDistance(plane, current.clip_position);
+    ElemType next_distance = GetPlaneDistance(plane, next.clip_position);
+
+    if (current_distance >= 0) {
+      result.vertices[result.size++] = current;
+    }
+    if ((current_distance >= 0) != (next_distance >= 0)) {
+      ElemType t = current_distance / (current_distance - next_distance);
+      result.vertices[result.size++] = {
+          .clip_position =
+              interpolate(current.clip_position, next.clip_position, t),
+          .position = interpolate(current.position, next.position, t),
+          .normal = interpolate(current.normal, next.normal, t),
+          .texture_coord =
+              interpolate(current.texture_coord, next.texture_coord, t)};
+    }
+  }
+  polygon = result;
+}
+
+}  // namespace Rendering
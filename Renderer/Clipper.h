@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include "../MathUtils/Triangle.h"
+#include "../Object/TriangleData.h"
+
+namespace Rendering {
+
+// Triangle clipper working in homogeneous clip space, where the view volume
+// is -w <= x, y <= w and 0 <= z <= w.
+//
+// Vertices are first classified with outcodes. A triangle entirely outside
+// one plane is dropped and a triangle that only crosses the side planes is
+// left as is: the rasterizer clamps it to the screen anyway. Only triangles
+// crossing the near or far plane, or reaching out of the guard band (kGUARD_BAND
+// times the view volume in x and y), are cut, and that is done on a
+// fixed-size polygon without allocating.
+class Clipper {
+  using ElemType = Linear::ElemType;
+  using Point4 = Linear::Point4;
+  using Triangle = Linear::Triangle;
+  using Index = Linear::Index;
+  using TriangleData = Scene::TriangleData;
+
+public:
+  // Keeps screen coordinates small enough for exact edge function stepping
+  static constexpr ElemType kGUARD_BAND = 4;
+
+  // Every clipping plane adds at most one vertex to a convex polygon
+  static constexpr Index kPLANES_COUNT = 6;
+  static constexpr Index kMAX_POLYGON_SIZE = 3 + kPLANES_COUNT;
+
+  enum class ClipResult { Inside, Outside, Clipped };
+
+  // Polygon vertex with the attributes interpolated along with it
+  struct Vertex {
+    Point4 clip_position;
+    Point4 position;
+    Point4 normal;
+    Point4 texture_coord;
+  };
+
+  struct Polygon {
+    std::array<Vertex, kMAX_POLYGON_SIZE> vertices;
+    Index size = 0;
+  };
+
+  // Outcode test alone: Clipped means the triangle would have to be cut
+  ClipResult Classify(const Triangle& clip_vertices) const;
+
+  // clip_vertices are the triangle's vertices in clip space. The polygon is
+  // only filled for ClipResult::Clipped and is convex, so it can be drawn as
+  // a fan around its first vertex.
+  ClipResult Clip(const TriangleData& triangle, const Triangle& clip_vertices,
+                  Polygon& polygon) const;
+
+private:
+  enum Outcode : unsigned {
+    kLEFT = 1 << 0,
+    kRIGHT = 1 << 1,
+    kBOTTOM = 1 << 2,
+    kTOP = 1 << 3,
+    kNEAR = 1 << 4,
+    kFAR = 1 << 5,
+    kGUARD_LEFT = 1 << 6,
+    kGUARD_RIGHT = 1 << 7,
+    kGUARD_BOTTOM = 1 << 8,
+    kGUARD_TOP = 1 << 9,
+  };
+
+  static constexpr unsigned kVIEW_VOLUME_PLANES =
+      kLEFT | kRIGHT | kBOTTOM | kTOP | kNEAR | kFAR;
+  static constexpr unsigned kCLIPPING_PLANES =
+      kNEAR | kFAR | kGUARD_LEFT | kGUARD_RIGHT | kGUARD_BOTTOM | kGUARD_TOP;
+
+  static unsigned ComputeOutcode(const Point4& clip_position);
+
+  // Signed distance-like value that is non-negative inside the plane
+  static ElemType GetPlaneDistance(Outcode plane, const Point4& clip_position);
+
+  static void ClipPolygon(Outcode plane, Polygon& polygon);
+};
+
+}  // namespace Rendering
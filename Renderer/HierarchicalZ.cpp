@@ -0,0 +1,96 @@
+#include "HierarchicalZ.h"
+#include <algorithm>
+#include <limits>
+
+namespace Rendering {
+
+void HierarchicalZ::Reset(WindowSize window_size, Index max_block_size,
+                          ZDepth clear_depth) {
+  window_size_ = window_size;
+
+  Index levels_count = 0;
+  for (Index block_size = kBLOCK_SIZE; block_size <= max_block_size;
+       block_size *= 2) {
+    ++levels_count;
+  }
+  levels_.resize(levels_count);
+
+  Index block_size = kBLOCK_SIZE;
+  for (auto& level : levels_) {
+    level.block_size = block_size;
+    level.width = (window_size.width + block_size - 1) / block_size;
+    level.height = (window_size.height + block_size - 1) / block_size;
+    level.max_depth.assign(level.width * level.height, clear_depth);
+    block_size *= 2;
+  }
+}
+
+void HierarchicalZ::Clear(Index begin_x, Index begin_y, Index end_x,
+                          Index end_y, ZDepth clear_depth) {
+  for (auto& level : levels_) {
+    for (Index y = begin_y / level.block_size; y <= end_y / level.block_size;
+         ++y) {
+      auto row = level.max_depth.begin() + y * level.width;
+      std::fill(row + begin_x / level.block_size,
+                row + end_x / level.block_size + 1, clear_depth);
+    }
+  }
+}
+
+Detail::ZDepth HierarchicalZ::GetMaxDepth(Index begin_x, Index begin_y,
+                                          Index end_x, Index end_y) const {
+  Index side = std::max(end_x - begin_x, end_y - begin_y) + 1;
+
+  // The smallest level whose cells are at least as large as the rectangle,
+  // so at most 2x2 cells are visited
+  auto level_it = std::find_if(
+      levels_.begin(), levels_.end(),
+      [side](const Level& level) { return level.block_size >= side; });
+  const Level& level = level_it != levels_.end() ? *level_it : levels_.back();
+
+  ZDepth result = std::numeric_limits<ZDepth>::lowest();
+  for (Index y = begin_y / level.block_size; y <= end_y / level.block_size;
+       ++y) {
+    for (Index x = begin_x / level.block_size; x <= end_x / level.block_size;
+         ++x) {
+      result = std::max(result, level.max_depth[y * level.width + x]);
+    }
+  }
+  return result;
+}
+
+void HierarchicalZ::UpdateBlock(const ZBuffer& z_buffer, Index block_x,
+                                Index block_y) {
+  Index begin_x = block_x * kBLOCK_SIZE;
+  Index begin_y = block_y * kBLOCK_SIZE;
+  Index end_x = std::min<Index>(begin_x + kBLOCK_SIZE, window_size_.width);
+  Index end_y = std::min<Index>(begin_y + kBLOCK_SIZE, window_size_.height);
+
+  ZDepth block_max = z_buffer[begin_y * window_size_.width + begin_x];
+  for (Index y = begin_y; y < end_y; ++y) {
+    const ZDepth* row = &z_buffer[y * window_size_.width];
+    block_max =
+        std::max(block_max, *std::max_element(row + begin_x, row + end_x));
+  }
+  levels_[0].max_depth[block_y * levels_[0].width + block_x] = block_max;
+
+  // Every parent is the maximum of its (up to) four children
+  for (size_t i = 1; i < levels_.size(); ++i) {
+    const Level& child = levels_[i - 1];
+    Level& parent = levels_[i];
+    block_x /= 2;
+    block_y /= 2;
+
+    ZDepth parent_max = std::numeric_limits<ZDepth>::lowest();
+    for (Index y = 2 * block_y; y < std::min(2 * block_y + 2, child.height);
+         ++y) {
+      for (Index x = 2 * block_x; x < std::min(2 * block_x + 2, child.width);
+           ++x) {
+        parent_max = std::max(parent_max, child.max_depth[y * child.width + x]);
+      }
+    }
+    parent.max_depth[block_y * parent.width + block_x] = parent_max;
+  }
+}
+
+}  // namespace Rendering
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "../Detail/Palette.h"
+
+namespace Rendering {
+
+// Low-resolution pyramid of maximum depths over square pixel blocks. Level 0
+// covers kBLOCK_SIZE x kBLOCK_SIZE pixels per cell and every next level
+// doubles the block side, up to the side passed to Reset. Since depth only
+// ever decreases, a fragment that is not nearer than a cell's maximum can not
+// pass the depth test anywhere inside that cell.
+class HierarchicalZ {
+  using Index = Linear::Index;
+  using ZDepth = Detail::ZDepth;
+  using ZBuffer = Detail::ZBuffer;
+  using WindowSize = Detail::WindowSize;
+
+public:
+  static constexpr Index kBLOCK_SIZE = 8;
+
+  // Resizes the pyramid for the window and fills it with clear_depth. Cells
+  // of the top level are max_block_size pixels wide.
+  void Reset(WindowSize window_size, Index max_block_size, ZDepth clear_depth);
+
+  // Fills the cells over a pixel rectangle with clear_depth on every level,
+  // bounds are inclusive. The rectangle must be aligned to the top level
+  // cells, so that no cell is shared with pixels outside of it.
+  void Clear(Index begin_x, Index begin_y, Index end_x, Index end_y,
+             ZDepth clear_depth);
+
+  // Maximum depth over a pixel rectangle, bounds are inclusive. The result
+  // is conservative: it may cover a slightly larger area than requested.
+  ZDepth GetMaxDepth(Index begin_x, Index begin_y, Index end_x,
+                     Index end_y) const;
+
+  // Recomputes the level 0 cell from the depth buffer and propagates the new
+  // value up the pyramid.
+  void UpdateBlock(const ZBuffer& z_buffer, Index block_x, Index block_y);
+
+private:
+  struct Level {
+    Index block_size;
+    Index width;
+    Index height;
+    std::vector<ZDepth> max_depth;
+  };
+
+  WindowSize window_size_{};
+  std::vector<Level> levels_;
+};
+
+}  // namespace Rendering
@@ -53,14 +53,14 @@ Linear::ElemType LightManager::ComputeShadowMap(
 }
 
 Linear::ElemType LightManager::ComputeShadowFactor(
-    const std::vector<Object>& objects, TriangleData& triangle,
+    const std::vector<Object>& objects, const TriangleData& triangle,
     const Point4& barycentric_point, const Lights& light_container) {
   ElemType shadow_factor = 1;
   return shadow_factor;
 }
 
 Linear::ElemType LightManager::ComputeLightning(
-    const std::vector<Object>& objects, TriangleData& triangle,
+    const std::vector<Object>& objects, const TriangleData& triangle,
     const Point4& barycentric_point, const Lights& light_container) const {
 
   Point4 real_point =
@@ -73,8 +73,8 @@ Linear::ElemType LightManager::ComputeLightning(
   for (const auto& light : light_container) {
     lightning_unit += light.ambient;
 
-    ElemType diffuse_intensity = std::max(
-        0.0, Linear::DotProduct(normal, Linear::Normalize(light.position)));
+    ElemType diffuse_intensity = std::max<ElemType>(
+        0, Linear::DotProduct(normal, Linear::Normalize(light.position)));
     lightning_unit += diffuse_intensity * light.diffuse;
   }
 
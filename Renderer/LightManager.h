@@ -51,13 +51,13 @@ public:
 
   // Required for shadow mapping
   ElemType ComputeShadowFactor(const std::vector<Object>& objects,
-                               TriangleData& triangle,
+                               const TriangleData& triangle,
                                const Point4& barycentric_point,
                                const Lights& light_container);
 
   // Simple Lambert model
   ElemType ComputeLightning(const std::vector<Object>& objects,
-                            TriangleData& triangle,
+                            const TriangleData& triangle,
                             const Point4& barycentric_point,
                             const Lights& light_container) const;
 
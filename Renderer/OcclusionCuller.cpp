@@ -0,0 +1,140 @@
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Rendering {
+
+namespace {
+
+constexpr Linear::ElemType kFAR_DEPTH =
+    std::numeric_limits<Linear::ElemType>::max();
+
+}  // namespace
+
+void OcclusionCuller::Reset(WindowSize window_size) {
+  window_size_ = window_size;
+  width_ = (window_size.width + kCELL_SIZE - 1) / kCELL_SIZE;
+  height_ = (window_size.height + kCELL_SIZE - 1) / kCELL_SIZE;
+  max_depth_.assign(width_ * height_, kFAR_DEPTH);
+}
+
+void OcclusionCuller::RasterizeOccluder(const Triangle& clip_vertices) {
+  std::array<Point4, 3> vertices{ConvertToScreen(clip_vertices(0)),
+                                 ConvertToScreen(clip_vertices(1)),
+                                 ConvertToScreen(clip_vertices(2))};
+
+  // Doubled signed area of (begin, end, point), as in the rasterizer
+  auto edge = [](const Point4& begin, const Point4& end, ElemType x,
+                 ElemType y) {
+    return (end(0) - begin(0)) * (y - begin(1)) -
+           (end(1) - begin(1)) * (x - begin(0));
+  };
+  ElemType area = edge(vertices[0], vertices[1], vertices[2](0),
+                       vertices[2](1));
+  if (std::abs(area) < kDEPTH_EPS) {
+    return;
+  }
+
+  // Depth at a corner if the triangle covers it, kFAR_DEPTH otherwise
+  auto covered_depth = [&](ElemType x, ElemType y) {
+    ElemType weight0 = edge(vertices[1], vertices[2], x, y) / area;
+    ElemType weight1 = edge(vertices[2], vertices[0], x, y) / area;
+    ElemType weight2 = edge(vertices[0], vertices[1], x, y) / area;
+    if (weight0 < 0 || weight1 < 0 || weight2 < 0) {
+      return kFAR_DEPTH;
+    }
+    return weight0 * vertices[0](2) + weight1 * vertices[1](2) +
+           weight2 * vertices[2](2);
+  };
+
+  ElemType min_x = std::min({vertices[0](0), vertices[1](0), vertices[2](0)});
+  ElemType max_x = std::max({vertices[0](0), vertices[1](0), vertices[2](0)});
+  ElemType min_y = std::min({vertices[0](1), vertices[1](1), vertices[2](1)});
+  ElemType max_y = std::max({vertices[0](1), vertices[1](1), vertices[2](1)});
+
+  Index begin_x = std::max<Index>(0, std::floor(min_x / kCELL_SIZE));
+  Index begin_y = std::max<Index>(0, std::floor(min_y / kCELL_SIZE));
+  Index end_x = std::min<Index>(width_ - 1, std::floor(max_x / kCELL_SIZE));
+  Index end_y = std::min<Index>(height_ - 1, std::floor(max_y / kCELL_SIZE));
+
+  for (Index cell_y = begin_y; cell_y <= end_y; ++cell_y) {
+    ElemType top = cell_y * kCELL_SIZE - kMARGIN;
+    ElemType bottom =
+        std::min<Index>((cell_y + 1) * kCELL_SIZE, window_size_.height) - 1 +
+        kMARGIN;
+    for (Index cell_x = begin_x; cell_x <= end_x; ++cell_x) {
+      ElemType left = cell_x * kCELL_SIZE - kMARGIN;
+      ElemType right =
+          std::min<Index>((cell_x + 1) * kCELL_SIZE, window_size_.width) - 1 +
+          kMARGIN;
+
+      // The triangle is convex and its depth is affine, so covering the
+      // corners covers the cell and the farthest corner bounds its depth
+      ElemType depth = std::max({covered_depth(left, top),
+                                 covered_depth(right, top),
+                                 covered_depth(left, bottom),
+                                 covered_depth(right, bottom)});
+      ElemType& cell = max_depth_[cell_y * width_ + cell_x];
+      cell = std::min(cell, depth);
+    }
+  }
+}
+
+bool OcclusionCuller::IsOccluded(
+    const Scene::BoundingBox& box,
+    const TransformMatrix4x4& frustum_matrix) const {
+  ElemType min_x = kFAR_DEPTH;
+  ElemType min_y = kFAR_DEPTH;
+  ElemType max_x = -kFAR_DEPTH;
+  ElemType max_y = -kFAR_DEPTH;
+  ElemType nearest_depth = kFAR_DEPTH;
+
+  for (Index corner = 0; corner < 8; ++corner) {
+    Point4 position{corner & 1 ? box.max_corner(0) : box.min_corner(0),
+                    corner & 2 ? box.max_corner(1) : box.min_corner(1),
+                    corner & 4 ? box.max_corner(2) : box.min_corner(2), 1};
+    Point4 clip_position = Linear::Transform(frustum_matrix, position);
+    if (clip_position(2) < 0 || clip_position(3) <= 0) {
+      return false;
+    }
+    Point4 screen_position = ConvertToScreen(clip_position);
+    min_x = std::min(min_x, screen_position(0));
+    min_y = std::min(min_y, screen_position(1));
+    max_x = std::max(max_x, screen_position(0));
+    max_y = std::max(max_y, screen_position(1));
+    nearest_depth = std::min(nearest_depth, screen_position(2));
+  }
+
+  min_x = std::max<ElemType>(0, min_x - kMARGIN);
+  min_y = std::max<ElemType>(0, min_y - kMARGIN);
+  max_x = std::min<ElemType>(window_size_.width - 1, max_x + kMARGIN);
+  max_y = std::min<ElemType>(window_size_.height - 1, max_y + kMARGIN);
+  if (min_x > max_x || min_y > max_y) {
+    return false;
+  }
+
+  for (Index cell_y = Index(min_y) / kCELL_SIZE;
+       cell_y <= Index(max_y) / kCELL_SIZE; ++cell_y) {
+    for (Index cell_x = Index(min_x) / kCELL_SIZE;
+         cell_x <= Index(max_x) / kCELL_SIZE; ++cell_x) {
+      if (max_depth_[cell_y * width_ + cell_x] + kDEPTH_EPS >= nearest_depth) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+Linear::Point4 OcclusionCuller::ConvertToScreen(
+    const Point4& clip_position) const {
+  ElemType inverse_w = 1 / clip_position(3);
+  ElemType x = clip_position(0) * inverse_w;
+  ElemType y = clip_position(1) * inverse_w;
+  return {(x + 1) * ElemType(0.5) * (window_size_.width - 1),
+          (1 - (y + 1) * ElemType(0.5)) * (window_size_.height - 1),
+          clip_position(2) * inverse_w, 1};
+}
+
+}  // namespace Rendering
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include "../Detail/Palette.h"
+#include "../MathUtils/Triangle.h"
+#include "../Object/Bounds.h"
+
+namespace Rendering {
+
+// Coarse occlusion test run before any per-triangle work of the frame.
+//
+// A few large occluders are rasterized into a low-resolution depth buffer
+// where every kCELL_SIZE x kCELL_SIZE cell keeps the farthest occluder depth
+// over the cell, written only for cells an occluder covers completely. An
+// object whose nearest point is behind that depth in every cell its screen
+// rectangle touches can not produce a visible pixel and is dropped.
+//
+// Both sides are conservative: occluder cells shrink by kMARGIN pixels and
+// object rectangles grow by it, which absorbs the rounding of vertices to
+// pixels in the rasterizer. Depths are clip z over w, as in the z-buffer.
+class OcclusionCuller {
+  using ElemType = Linear::ElemType;
+  using Point4 = Linear::Point4;
+  using Triangle = Linear::Triangle;
+  using TransformMatrix4x4 = Linear::TransformMatrix4x4;
+  using Index = Linear::Index;
+  using WindowSize = Detail::WindowSize;
+
+public:
+  static constexpr Index kCELL_SIZE = 8;
+  static constexpr Index kMARGIN = 2;
+  static constexpr ElemType kDEPTH_EPS = 1e-5;
+
+  // Resizes the buffer for the window and forgets all occluders
+  void Reset(WindowSize window_size);
+
+  // clip_vertices must be inside the near, far and guard band planes, which
+  // is what Clipper::Classify reports as Inside
+  void RasterizeOccluder(const Triangle& clip_vertices);
+
+  // box is the object's bounding box in camera-relative coordinates and
+  // frustum_matrix maps them to clip space. Boxes reaching behind the near
+  // plane are never occluded.
+  bool IsOccluded(const Scene::BoundingBox& box,
+                  const TransformMatrix4x4& frustum_matrix) const;
+
+private:
+  // Pixel coordinates before rounding, with the depth in the third component
+  Point4 ConvertToScreen(const Point4& clip_position) const;
+
+  WindowSize window_size_{};
+  Index width_ = 0;
+  Index height_ = 0;
+  std::vector<ElemType> max_depth_;
+};
+
+}  // namespace Rendering
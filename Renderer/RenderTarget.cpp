@@ -0,0 +1,169 @@
+#include "RenderTarget.h"
+#include <algorithm>
+
+namespace Rendering {
+
+RenderTarget::RenderTarget(WindowSize window_size) {
+  Resize(window_size);
+}
+
+void RenderTarget::Resize(WindowSize window_size) {
+  if (window_size.height == window_size_.height &&
+      window_size.width == window_size_.width && !tile_written_.empty()) {
+    return;
+  }
+  window_size_ = window_size;
+
+  Index pixels_count = GetPixelsCount();
+  if (!external_pixels_) {
+    pixels_.assign(pixels_count, kCLEAR_COLOR);
+  }
+  z_buffer_.assign(pixels_count, kCLEAR_DEPTH);
+  hierarchical_z_.Reset(window_size, kTILE_SIZE, kCLEAR_DEPTH);
+  if (!visibility_buffer_.empty()) {
+    visibility_buffer_.assign(pixels_count, {});
+  }
+
+  tile_written_.assign(GetTilesCount(), false);
+  // Tiles of the old size say nothing about the new ones
+  color_buffers_.clear();
+  oldest_color_buffer_ = 0;
+  SelectColorBuffer(external_pixels_);
+}
+
+void RenderTarget::AttachColorBuffer(Color* pixels, WindowSize window_size) {
+  external_pixels_ = pixels;
+  ScreenPicture().swap(pixels_);
+  Resize(window_size);
+  SelectColorBuffer(pixels);
+}
+
+void RenderTarget::DetachColorBuffer() {
+  if (!external_pixels_) {
+    return;
+  }
+  external_pixels_ = nullptr;
+  pixels_.assign(GetPixelsCount(), kCLEAR_COLOR);
+  SelectColorBuffer(nullptr);
+  std::vector<unsigned char>& written =
+      color_buffers_[color_buffer_index_].written;
+  std::fill(written.begin(), written.end(), false);
+}
+
+Detail::WindowSize RenderTarget::GetWindowSize() const {
+  return window_size_;
+}
+
+Detail::Color* RenderTarget::GetPixels() {
+  return external_pixels_ ? external_pixels_ : pixels_.data();
+}
+
+const Detail::Color* RenderTarget::GetPixels() const {
+  return external_pixels_ ? external_pixels_ : pixels_.data();
+}
+
+Detail::ScreenPicture& RenderTarget::GetPicture() {
+  return pixels_;
+}
+
+Detail::ZBuffer& RenderTarget::GetZBuffer() {
+  return z_buffer_;
+}
+
+HierarchicalZ& RenderTarget::GetHierarchicalZ() {
+  return hierarchical_z_;
+}
+
+VisibilityBuffer& RenderTarget::GetVisibilityBuffer() {
+  if (visibility_buffer_.empty()) {
+    visibility_buffer_.assign(GetPixelsCount(), {});
+  }
+  return visibility_buffer_;
+}
+
+Linear::Index RenderTarget::GetTilesCountX() const {
+  return (window_size_.width + kTILE_SIZE - 1) / kTILE_SIZE;
+}
+
+Linear::Index RenderTarget::GetTilesCount() const {
+  return GetTilesCountX() *
+         ((window_size_.height + kTILE_SIZE - 1) / kTILE_SIZE);
+}
+
+PixelRect RenderTarget::GetTileRect(Index tile_index) const {
+  Index tile_x = (tile_index % GetTilesCountX()) * kTILE_SIZE;
+  Index tile_y = (tile_index / GetTilesCountX()) * kTILE_SIZE;
+  return {.begin_x = tile_x,
+          .begin_y = tile_y,
+          .end_x = std::min<Index>(tile_x + kTILE_SIZE, window_size_.width) - 1,
+          .end_y =
+              std::min<Index>(tile_y + kTILE_SIZE, window_size_.height) - 1};
+}
+
+void RenderTarget::ClearTile(Index tile_index) {
+  PixelRect rect = GetTileRect(tile_index);
+
+  unsigned char& color_written =
+      color_buffers_[color_buffer_index_].written[tile_index];
+  if (color_written) {
+    Color* pixels = GetPixels();
+    for (Index i = rect.begin_y; i <= rect.end_y; ++i) {
+      Index row_begin = i * window_size_.width + rect.begin_x;
+      Index row_end = i * window_size_.width + rect.end_x + 1;
+      std::fill(pixels + row_begin, pixels + row_end, kCLEAR_COLOR);
+    }
+    color_written = false;
+  }
+
+  if (!tile_written_[tile_index]) {
+    return;
+  }
+  for (Index i = rect.begin_y; i <= rect.end_y; ++i) {
+    Index row_begin = i * window_size_.width + rect.begin_x;
+    Index row_end = i * window_size_.width + rect.end_x + 1;
+    std::fill(z_buffer_.begin() + row_begin, z_buffer_.begin() + row_end,
+              kCLEAR_DEPTH);
+    if (!visibility_buffer_.empty()) {
+      std::fill(visibility_buffer_.begin() + row_begin,
+                visibility_buffer_.begin() + row_end, VisibilitySample{});
+    }
+  }
+  hierarchical_z_.Clear(rect.begin_x, rect.begin_y, rect.end_x, rect.end_y,
+                        kCLEAR_DEPTH);
+
+  tile_written_[tile_index] = false;
+}
+
+void RenderTarget::SetTileWritten(Index tile_index, bool written) {
+  tile_written_[tile_index] = written;
+  color_buffers_[color_buffer_index_].written[tile_index] = written;
+}
+
+Linear::Index RenderTarget::GetPixelsCount() const {
+  return Index{window_size_.width} * window_size_.height;
+}
+
+void RenderTarget::SelectColorBuffer(const Color* pixels) {
+  auto it = std::find_if(
+      color_buffers_.begin(), color_buffers_.end(),
+      [pixels](const ColorBufferTiles& tiles) { return tiles.pixels == pixels; });
+  if (it != color_buffers_.end()) {
+    color_buffer_index_ = it - color_buffers_.begin();
+    return;
+  }
+
+  if (color_buffers_.size() < kMAX_COLOR_BUFFERS) {
+    color_buffer_index_ = color_buffers_.size();
+    color_buffers_.emplace_back();
+  } else {
+    color_buffer_index_ = oldest_color_buffer_;
+    oldest_color_buffer_ = (oldest_color_buffer_ + 1) % kMAX_COLOR_BUFFERS;
+  }
+  ColorBufferTiles& tiles = color_buffers_[color_buffer_index_];
+  tiles.pixels = pixels;
+  // The owned buffer is allocated clear, contents of a new external one are
+  // unknown
+  tiles.written.assign(GetTilesCount(), pixels != nullptr);
+}
+
+}  // namespace Rendering
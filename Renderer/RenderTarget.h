@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "../Detail/Palette.h"
+#include "HierarchicalZ.h"
+
+namespace Rendering {
+
+// Pixel rectangle with inclusive bounds
+struct PixelRect {
+  using Index = Linear::Index;
+
+  Index begin_x;
+  Index begin_y;
+  Index end_x;
+  Index end_y;
+};
+
+// Visibility buffer entry of the deferred shading mode: the frame triangle
+// that owns the pixel and the pixel's barycentric coordinates in it.
+struct VisibilitySample {
+  static constexpr Linear::Index kEMPTY = -1;
+
+  Linear::Index triangle_index = kEMPTY;
+  std::array<Linear::ElemType, 3> barycentric;
+};
+
+using VisibilityBuffer = std::vector<VisibilitySample>;
+
+// Color, depth and visibility buffers of a frame together with the depth
+// pyramid, kept between frames so that only a resize reallocates them. The
+// color buffer is either owned or provided by the caller.
+//
+// The frame is split into kTILE_SIZE x kTILE_SIZE tiles. Buffers are not
+// cleared up front: the renderer clears each tile right before rasterizing
+// it, and a tile the previous frame left untouched is not cleared at all.
+// Color buffers are tracked separately, so that alternating between a few
+// attached buffers keeps clearing only the tiles each of them had written.
+class RenderTarget {
+  using Index = Linear::Index;
+  using Color = Detail::Color;
+  using ZDepth = Detail::ZDepth;
+  using ScreenPicture = Detail::ScreenPicture;
+  using ZBuffer = Detail::ZBuffer;
+  using WindowSize = Detail::WindowSize;
+
+public:
+  static constexpr Index kTILE_SIZE = 64;
+  static constexpr Color kCLEAR_COLOR = 0x000000;
+  static constexpr ZDepth kCLEAR_DEPTH = 0xFFFFFF;
+
+  RenderTarget() = default;
+  explicit RenderTarget(WindowSize window_size);
+
+  // Reallocates the buffers if the size differs from the current one
+  void Resize(WindowSize window_size);
+
+  // Renders into window_size.width * window_size.height colors owned by the
+  // caller from now on. The renderer assumes it is the only writer of that
+  // memory between frames, also while other buffers are attached.
+  void AttachColorBuffer(Color* pixels, WindowSize window_size);
+  void DetachColorBuffer();
+
+  WindowSize GetWindowSize() const;
+
+  Color* GetPixels();
+  const Color* GetPixels() const;
+
+  // Owned color buffer, empty while an external one is attached
+  ScreenPicture& GetPicture();
+
+  ZBuffer& GetZBuffer();
+  HierarchicalZ& GetHierarchicalZ();
+
+  // Allocated on first use, so forward-only targets do not pay for it
+  VisibilityBuffer& GetVisibilityBuffer();
+
+  Index GetTilesCountX() const;
+  Index GetTilesCount() const;
+  PixelRect GetTileRect(Index tile_index) const;
+
+  // Restores the clear values inside the tile unless it is already clear.
+  // Different tiles may be cleared concurrently.
+  void ClearTile(Index tile_index);
+
+  // Records whether the current frame wrote anything into the tile
+  void SetTileWritten(Index tile_index, bool written);
+
+private:
+  // Buffers whose tiles are remembered, the most a caller alternates between
+  static constexpr Index kMAX_COLOR_BUFFERS = 4;
+
+  // Tiles of a color buffer that may hold anything but the clear color
+  struct ColorBufferTiles {
+    // Null for the owned buffer
+    const Color* pixels;
+    std::vector<unsigned char> written;
+  };
+
+  Index GetPixelsCount() const;
+
+  // Makes the buffer current, starting to track it if it is new. A new
+  // buffer replaces the one tracked the longest when there are too many.
+  void SelectColorBuffer(const Color* pixels);
+
+  WindowSize window_size_{};
+
+  ScreenPicture pixels_;
+  Color* external_pixels_ = nullptr;
+
+  ZBuffer z_buffer_;
+  HierarchicalZ hierarchical_z_;
+  VisibilityBuffer visibility_buffer_;
+
+  // One byte per tile rather than std::vector<bool>, so that tiles are
+  // separate objects for the worker threads. Covers the depth, pyramid and
+  // visibility buffers, which every color buffer shares.
+  std::vector<unsigned char> tile_written_;
+  std::vector<ColorBufferTiles> color_buffers_;
+  Index color_buffer_index_ = 0;
+  // Next to be replaced once kMAX_COLOR_BUFFERS are tracked
+  Index oldest_color_buffer_ = 0;
+};
+
+}  // namespace Rendering
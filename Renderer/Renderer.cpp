@@ -1,13 +1,20 @@
 #include "Renderer.h"
 #include <algorithm>
-#include <queue>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <span>
 #include <vector>
+#include "../Profiling/PerfCounters.h"
+#include "../Profiling/Trace.h"
+#include "SimdBatch.h"
 
 namespace Rendering {
 
 void Renderer::CameraRatioCheck(Camera& camera, WindowSize window_size) {
-  double aspect_ratio = static_cast<double>(window_size.width) /
-                        static_cast<double>(window_size.height);
+  ElemType aspect_ratio = static_cast<ElemType>(window_size.width) /
+                          static_cast<ElemType>(window_size.height);
   if (camera.GetAspectRatio() != aspect_ratio) {
     camera.SetAspectRatio(aspect_ratio);
   }
@@ -32,12 +39,13 @@ Linear::Point4 Renderer::ComputeBarycentric(const Point4& point,
   ElemType area20 =
       Triangle{triangle(2), triangle(0), point}.GetAreaXYProjection();
 
-  return {area01 / triangle_area, area12 / triangle_area,
-          area20 / triangle_area, 0};
+  // The area spanned by the edge opposite a vertex is that vertex's weight
+  return {area12 / triangle_area, area20 / triangle_area,
+          area01 / triangle_area, 0};
 }
 
-Linear::ElemType Renderer::MultiplyColor(const Color& color,
-                                         const ElemType& scalar) {
+Detail::Color Renderer::MultiplyColor(const Color& color,
+                                      const ElemType& scalar) const {
   uint8_t a = (color >> 24) & 0xFF;
   uint8_t r = (color >> 16) & 0xFF;
   uint8_t g = (color >> 8) & 0xFF;
@@ -82,128 +90,6 @@ Detail::Color Renderer::GetTextureColor(const Material* const material,
   return kDEFAULT_COLOR;
 }
 
-void Renderer::ClipTrianglesThroughPlane(const Plane& plane,
-                                         std::queue<TriangleData>& clip_pool) {
-  //  The method accepts a std::queue of triangles and performs clipping through the plane.
-  //  The plane divides space into two half-spaces: S+ (where the dot product of any vector with the plane normal
-  //  is non-negative) and S– (where it is negative). The method processes all triangles
-  //  that were in the queue before this method was launched. For each triangle:
-  //
-  //  - If the triangle lies completely in S–, it is skipped.
-  //  - If the triangle lies completely in S+, it is appended to the end of the queue.
-  //  - If the triangle intersects the plane, it is clipped into one or more sub-triangles,
-  //    and those sub-triangles that lie in S+ are appended to the end of the queue.
-  size_t pool_size = clip_pool.size();
-  for (size_t i = 0; i < pool_size; ++i) {
-    TriangleData curr = clip_pool.front();
-    clip_pool.pop();
-
-    ElemType dist0 = plane.GetDistance(curr.vertices(0));
-    ElemType dist1 = plane.GetDistance(curr.vertices(1));
-    ElemType dist2 = plane.GetDistance(curr.vertices(2));
-
-    if (dist0 < -kEPS && dist1 < -kEPS && dist2 < -kEPS) {
-      continue;
-    } else if (dist0 > kEPS && dist1 > kEPS && dist2 > kEPS) {
-      clip_pool.push(curr);
-      continue;
-    }
-
-    auto interpolate = [](const Point4& a, const Point4& b, ElemType t) {
-      return a + (b - a) * t;
-    };
-
-    auto interpolate_attr = [&](const Linear::Triangle& attr, int i0, int i1,
-                                ElemType t) {
-      return interpolate(attr(i0), attr(i1), t);
-    };
-
-    auto intersect = [&](int begin_vertex_index, int end_vertex_index) {
-      OffsetedVector vec{curr.vertices(begin_vertex_index),
-                         curr.vertices(end_vertex_index)};
-      IntersectionResult intersection_result =
-          plane.GetIntersectWithVector(vec);
-      ElemType dist_begin = plane.GetDistance(vec.begin);
-      ElemType dist_end = plane.GetDistance(vec.end);
-      ElemType t = dist_begin / (dist_begin - dist_end);
-      return std::make_tuple(
-          intersection_result.intersection,
-          interpolate_attr(curr.normals, begin_vertex_index, end_vertex_index,
-                           t),
-          interpolate_attr(curr.texture_coords, begin_vertex_index,
-                           end_vertex_index, t));
-    };
-
-    auto [intersect_01, normal_01, texture_coords_01] = intersect(0, 1);
-    auto [intersect_12, normal_12, texture_coords_12] = intersect(1, 2);
-    auto [intersect_20, normal_20, texture_coords_20] = intersect(2, 0);
-
-    if (dist0 <= 0) {
-      if (dist1 <= 0) {
-        // Vertices 0 and 1 outside of S+, only 2 in S+
-        clip_pool.push(
-            {{intersect_20, intersect_12, curr.vertices(2)},
-             {normal_20, normal_12, curr.normals(2)},
-             {texture_coords_20, texture_coords_12, curr.texture_coords(2)},
-             curr.material_index});
-      } else if (dist2 <= 0) {
-        // Vertices 0 and 2 outside of S+, only 1 in S+
-        clip_pool.push(
-            {{intersect_01, curr.vertices(1), intersect_12},
-             {normal_01, curr.normals(1), normal_12},
-             {texture_coords_01, curr.texture_coords(1), texture_coords_12},
-             curr.material_index});
-      } else {
-        // Vertex 0 is outside of S+, and 1 and 2 are in S+
-        clip_pool.push({{intersect_01, curr.vertices(1), curr.vertices(2)},
-                        {normal_01, curr.normals(1), curr.normals(2)},
-                        {texture_coords_01, curr.texture_coords(1),
-                         curr.texture_coords(2)},
-                        curr.material_index});
-        clip_pool.push(
-            {{intersect_01, curr.vertices(2), intersect_20},
-             {normal_01, curr.normals(2), normal_20},
-             {texture_coords_01, curr.texture_coords(2), texture_coords_20},
-             curr.material_index});
-      }
-    } else if (dist1 <= 0) {
-      // Vertex 1 is outside of S+, and 0 is in S+
-      if (dist2 <= 0) {
-        // Only 0 in S+
-        clip_pool.push(
-            {{curr.vertices(0), intersect_01, intersect_20},
-             {curr.normals(0), normal_01, normal_20},
-             {curr.texture_coords(0), texture_coords_01, texture_coords_20},
-             curr.material_index});
-      } else {
-        // Vertices 0 and 2 in S+, vertex 1 outside S+
-        clip_pool.push(
-            {{curr.vertices(0), intersect_01, intersect_12},
-             {curr.normals(0), normal_01, normal_12},
-             {curr.texture_coords(0), texture_coords_01, texture_coords_12},
-             curr.material_index});
-        clip_pool.push({{curr.vertices(0), intersect_12, curr.vertices(2)},
-                        {curr.normals(0), normal_12, curr.normals(2)},
-                        {curr.texture_coords(0), texture_coords_12,
-                         curr.texture_coords(2)},
-                        curr.material_index});
-      }
-    } else {
-      // Vertices 0 and 1 are in S+, and 2 are outside S+
-      clip_pool.push(
-          {{curr.vertices(0), curr.vertices(1), intersect_12},
-           {curr.normals(0), curr.normals(1), normal_12},
-           {curr.texture_coords(0), curr.texture_coords(1), texture_coords_12},
-           curr.material_index});
-      clip_pool.push(
-          {{curr.vertices(0), intersect_12, intersect_20},
-           {curr.normals(0), normal_12, normal_20},
-           {curr.texture_coords(0), texture_coords_12, texture_coords_20},
-           curr.material_index});
-    }
-  }
-}
-
 void Renderer::DrawPixel(const WindowSize& window_size, ScreenPicture& pixels,
                          ZBuffer& z_buffer, const ScreenPoint& location,
                          Color color) {
@@ -263,171 +149,789 @@ void Renderer::DrawLine(const ScreenPoint& begin, const ScreenPoint& end,
 void Renderer::DrawBorder(const TriangleData& triangle_data,
                           const WindowSize& window_size, ScreenPicture& pixels,
                           ZBuffer& z_buffer, Color color) {
-  DrawLine({.x = Width{int(triangle_data.vertices(0)(0))},
-            .y = Height{int(triangle_data.vertices(0)(1))},
+  DrawLine({.y = Height{int(triangle_data.vertices(0)(1))},
+            .x = Width{int(triangle_data.vertices(0)(0))},
             .depth = triangle_data.vertices(0)(2)},
-           {.x = Width{int(triangle_data.vertices(1)(0))},
-            .y = Height{int(triangle_data.vertices(1)(1))},
+           {.y = Height{int(triangle_data.vertices(1)(1))},
+            .x = Width{int(triangle_data.vertices(1)(0))},
             .depth = triangle_data.vertices(1)(2)},
            window_size, pixels, z_buffer, kBORDER_COLOR);
 
-  DrawLine({.x = Width{int(triangle_data.vertices(1)(0))},
-            .y = Height{int(triangle_data.vertices(1)(1))},
+  DrawLine({.y = Height{int(triangle_data.vertices(1)(1))},
+            .x = Width{int(triangle_data.vertices(1)(0))},
             .depth = triangle_data.vertices(1)(2)},
-           {.x = Width{int(triangle_data.vertices(2)(0))},
-            .y = Height{int(triangle_data.vertices(2)(1))},
+           {.y = Height{int(triangle_data.vertices(2)(1))},
+            .x = Width{int(triangle_data.vertices(2)(0))},
             .depth = triangle_data.vertices(2)(2)},
            window_size, pixels, z_buffer, kBORDER_COLOR);
 
-  DrawLine({.x = Width{int(triangle_data.vertices(2)(0))},
-            .y = Height{int(triangle_data.vertices(2)(1))},
+  DrawLine({.y = Height{int(triangle_data.vertices(2)(1))},
+            .x = Width{int(triangle_data.vertices(2)(0))},
             .depth = triangle_data.vertices(2)(2)},
-           {.x = Width{int(triangle_data.vertices(0)(0))},
-            .y = Height{int(triangle_data.vertices(0)(1))},
+           {.y = Height{int(triangle_data.vertices(0)(1))},
+            .x = Width{int(triangle_data.vertices(0)(0))},
             .depth = triangle_data.vertices(0)(2)},
            window_size, pixels, z_buffer, kBORDER_COLOR);
 }
 
+ScreenTriangle Renderer::SetupTriangle(const TriangleData& triangle_data,
+                                      const Material* const material,
+                                      const Camera& camera,
+                                      WindowSize window_size) {
+  Triangle clip_vertices = triangle_data.vertices;
+  clip_vertices.Transform(camera.GetFullFrustumMatrix());
+  return SetupTriangle(triangle_data, clip_vertices, material, window_size);
+}
+
+ScreenTriangle Renderer::SetupTriangle(const TriangleData& triangle_data,
+                                      const Triangle& clip_vertices,
+                                      const Material* const material,
+                                      WindowSize window_size) {
+  ScreenTriangle result{.view_triangle = triangle_data,
+                        .screen_vertices = clip_vertices,
+                        .material = material};
+
+  for (Index i = 0; i < 3; ++i) {
+    Point4& vertex = result.screen_vertices(i);
+    result.normalize_point(i) = 1 / vertex(3);
+    vertex = vertex * result.normalize_point(i);
+    vertex(0) = ConvertToScreenX(window_size, vertex(0));
+    vertex(1) = ConvertToScreenY(window_size, vertex(1));
+  }
+
+  result.area = result.screen_vertices.GetAreaXYProjection();
+  result.bounding_box =
+      GetBoundingBoxBorders(result.screen_vertices, window_size);
+
+  return result;
+}
+
 void Renderer::RasterizeTriangle(TriangleData& triangle_data,
                                  const Material* const material,
                                  const Camera& camera, WindowSize window_size,
                                  ScreenPicture& pixels, ZBuffer& z_buffer,
                                  const Lights& lights) {
+  ScreenTriangle triangle =
+      SetupTriangle(triangle_data, material, camera, window_size);
+  PixelRect screen_rect{.begin_x = 0,
+                        .begin_y = 0,
+                        .end_x = window_size.width - 1,
+                        .end_y = window_size.height - 1};
+  FrameBuffers buffers{.window_size = window_size,
+                       .pixels = pixels.data(),
+                       .z_buffer = z_buffer};
+
+  RasterizeTriangle(triangle, VisibilitySample::kEMPTY, screen_rect, buffers,
+                    lights);
+}
 
-  // For correct light computaion
-  TriangleData triangle_cpy = triangle_data;
+void Renderer::RasterizeTriangle(const ScreenTriangle& triangle,
+                                 Index triangle_index,
+                                 const PixelRect& clip_rect,
+                                 FrameBuffers& buffers, const Lights& lights) {
+  const Triangle& vertices = triangle.screen_vertices;
+
+  PixelRect rect{
+      .begin_x = std::max(Index(triangle.bounding_box.begin(0)),
+                          clip_rect.begin_x),
+      .begin_y = std::max(Index(triangle.bounding_box.begin(1)),
+                          clip_rect.begin_y),
+      .end_x = std::min(Index(triangle.bounding_box.end(0)), clip_rect.end_x),
+      .end_y = std::min(Index(triangle.bounding_box.end(1)), clip_rect.end_y)};
+  if (rect.begin_x > rect.end_x || rect.begin_y > rect.end_y) {
+    return;
+  }
 
-  // Frustum transform
-  triangle_data.vertices.Transform(camera.GetFullFrustumMatrix());
+  // Edge equations are set up once per triangle and stepped across the
+  // bounding box, so the per-pixel coverage test is a few adds and compares.
+  // Screen vertices and pixel centers are integers, so stepping is exact and
+  // matches ComputeBarycentric bit for bit. edges[i] is opposite vertex i and
+  // yields its barycentric weight.
+  std::array<EdgeFunction, 3> edges{EdgeFunction(vertices(1), vertices(2)),
+                                    EdgeFunction(vertices(2), vertices(0)),
+                                    EdgeFunction(vertices(0), vertices(1))};
+
+  auto rasterize_block = [&](const PixelRect& block) {
+    return simd_enabled_
+               ? RasterizeBlock<ElemBatch>(triangle, triangle_index, edges,
+                                           block, buffers, lights)
+               : RasterizeBlock<ScalarElemBatch>(triangle, triangle_index,
+                                                 edges, block, buffers, lights);
+  };
 
-  Point4 normalize_point;
-  for (Index i = 0; i < 3; ++i) {
-    normalize_point(i) = 1 / triangle_data.vertices(i)(3);
-    triangle_data.vertices(i) = triangle_data.vertices(i) * normalize_point(i);
-    triangle_data.vertices(i)(0) =
-        ConvertToScreenX(window_size, triangle_data.vertices(i)(0));
-    triangle_data.vertices(i)(1) =
-        ConvertToScreenY(window_size, triangle_data.vertices(i)(1));
+  HierarchicalZ* hierarchical_z = buffers.hierarchical_z;
+  if (!hierarchical_z) {
+    rasterize_block(rect);
+    return;
   }
 
-  ElemType triangle_area = triangle_data.vertices.GetAreaXYProjection();
+  // Coarse rejection: interpolated depth never goes below the nearest vertex,
+  // so the triangle is hidden wherever that is behind the stored maximum.
+  ElemType nearest_vertex =
+      std::min({vertices(0)(2), vertices(1)(2), vertices(2)(2)});
+  if (nearest_vertex - kHIZ_EPS >=
+      hierarchical_z->GetMaxDepth(rect.begin_x, rect.begin_y, rect.end_x,
+                                  rect.end_y)) {
+    return;
+  }
 
-  OffsetedVector bound_box_borders =
-      GetBoundingBoxBorders(triangle_data, window_size);
+  // Depth is affine in screen space, so over a rectangle it is smallest at
+  // one of the corners.
+  auto depth_at = [&](ElemType x, ElemType y) {
+    return (edges[0].Evaluate(x, y) * vertices(0)(2) +
+            edges[1].Evaluate(x, y) * vertices(1)(2) +
+            edges[2].Evaluate(x, y) * vertices(2)(2)) /
+           triangle.area;
+  };
 
-  for (Index i = bound_box_borders.begin(1); i <= bound_box_borders.end(1);
-       ++i) {
-    for (Index j = bound_box_borders.begin(0); j <= bound_box_borders.end(0);
-         ++j) {
-      Point4 barycentric_point =
-          ComputeBarycentric({ElemType(j), ElemType(i), 0, 0},
-                             triangle_data.vertices, triangle_area);
-      if (barycentric_point(0) >= -kEPS && barycentric_point(1) >= -kEPS &&
-          barycentric_point(2) >= -kEPS) {
-        ElemType depth =
-            triangle_data.vertices.GetPointByBarycentric(barycentric_point)(2);
+  constexpr Index kBLOCK_SIZE = HierarchicalZ::kBLOCK_SIZE;
+  for (Index block_y = rect.begin_y / kBLOCK_SIZE;
+       block_y <= rect.end_y / kBLOCK_SIZE; ++block_y) {
+    for (Index block_x = rect.begin_x / kBLOCK_SIZE;
+         block_x <= rect.end_x / kBLOCK_SIZE; ++block_x) {
+      PixelRect block{
+          .begin_x = std::max(rect.begin_x, block_x * kBLOCK_SIZE),
+          .begin_y = std::max(rect.begin_y, block_y * kBLOCK_SIZE),
+          .end_x = std::min(rect.end_x, (block_x + 1) * kBLOCK_SIZE - 1),
+          .end_y = std::min(rect.end_y, (block_y + 1) * kBLOCK_SIZE - 1)};
+
+      ElemType nearest = std::max(
+          nearest_vertex, std::min({depth_at(block.begin_x, block.begin_y),
+                                    depth_at(block.end_x, block.begin_y),
+                                    depth_at(block.begin_x, block.end_y),
+                                    depth_at(block.end_x, block.end_y)}));
+      if (nearest - kHIZ_EPS >=
+          hierarchical_z->GetMaxDepth(block.begin_x, block.begin_y,
+                                      block.end_x, block.end_y)) {
+        continue;
+      }
 
-        ElemType intensity = light_manager_.ComputeLightning(
-            {}, triangle_cpy, barycentric_point, lights);
+      if (rasterize_block(block)) {
+        hierarchical_z->UpdateBlock(buffers.z_buffer, block_x, block_y);
+      }
+    }
+  }
+}
 
-        Point4 texture_coord = ConstructTextureCoord(
-            triangle_cpy, barycentric_point, normalize_point);
+template <typename PixelBatch>
+bool Renderer::RasterizeBlock(const ScreenTriangle& triangle,
+                              Index triangle_index,
+                              const std::array<EdgeFunction, 3>& edges,
+                              const PixelRect& rect, FrameBuffers& buffers,
+                              const Lights& lights) {
+  const Triangle& vertices = triangle.screen_vertices;
+  const EdgeFunction& edge0 = edges[0];
+  const EdgeFunction& edge1 = edges[1];
+  const EdgeFunction& edge2 = edges[2];
+
+  ZBuffer& z_buffer = buffers.z_buffer;
+  VisibilityBuffer* visibility_buffer = buffers.visibility_buffer;
+  // Always null without the stats, so that the counting is compiled out
+  FrameStats* stats = Detail::kFRAME_STATS_ENABLED ? buffers.stats : nullptr;
+
+  ElemType row0 = edge0.Evaluate(rect.begin_x, rect.begin_y);
+  ElemType row1 = edge1.Evaluate(rect.begin_x, rect.begin_y);
+  ElemType row2 = edge2.Evaluate(rect.begin_x, rect.begin_y);
+
+  // The kernel evaluates kWIDTH horizontally adjacent pixels at once:
+  // coverage, depth interpolation, the depth test and the depth write are
+  // done on all lanes. Shading stays scalar and runs for the surviving lanes
+  // only. Shading is pure, so testing depth before shading yields the same
+  // image as DrawPixel.
+  constexpr Index kWIDTH = PixelBatch::kWIDTH;
+
+  const PixelBatch area = PixelBatch::Broadcast(triangle.area);
+  const PixelBatch min_barycentric = PixelBatch::Broadcast(-kEPS);
+  const PixelBatch depth0 = PixelBatch::Broadcast(vertices(0)(2));
+  const PixelBatch depth1 = PixelBatch::Broadcast(vertices(1)(2));
+  const PixelBatch depth2 = PixelBatch::Broadcast(vertices(2)(2));
+
+  const PixelBatch lanes0 = PixelBatch::Ramp(edge0.step_x);
+  const PixelBatch lanes1 = PixelBatch::Ramp(edge1.step_x);
+  const PixelBatch lanes2 = PixelBatch::Ramp(edge2.step_x);
+  const PixelBatch step0 = PixelBatch::Broadcast(edge0.step_x * kWIDTH);
+  const PixelBatch step1 = PixelBatch::Broadcast(edge1.step_x * kWIDTH);
+  const PixelBatch step2 = PixelBatch::Broadcast(edge2.step_x * kWIDTH);
+
+  alignas(32) std::array<ElemType, kWIDTH> lane_barycentric0;
+  alignas(32) std::array<ElemType, kWIDTH> lane_barycentric1;
+  alignas(32) std::array<ElemType, kWIDTH> lane_barycentric2;
+
+  bool written = false;
+  for (Index i = rect.begin_y; i <= rect.end_y; ++i, row0 += edge0.step_y,
+             row1 += edge1.step_y, row2 += edge2.step_y) {
+    PixelBatch area0 = PixelBatch::Broadcast(row0) + lanes0;
+    PixelBatch area1 = PixelBatch::Broadcast(row1) + lanes1;
+    PixelBatch area2 = PixelBatch::Broadcast(row2) + lanes2;
+
+    for (Index j = rect.begin_x; j <= rect.end_x; j += kWIDTH,
+               area0 = area0 + step0, area1 = area1 + step1,
+               area2 = area2 + step2) {
+      Index lanes_count = std::min(kWIDTH, rect.end_x - j + 1);
+      typename PixelBatch::Mask mask = (1u << lanes_count) - 1;
+
+      PixelBatch barycentric0 = area0 / area;
+      PixelBatch barycentric1 = area1 / area;
+      PixelBatch barycentric2 = area2 / area;
+      mask &= GreaterEqual(barycentric0, min_barycentric) &
+              GreaterEqual(barycentric1, min_barycentric) &
+              GreaterEqual(barycentric2, min_barycentric);
+      if (!mask) {
+        continue;
+      }
+      if (stats) {
+        stats->pixels_tested += std::popcount(mask);
+      }
 
-        Color texture_color = GetTextureColor(material, texture_coord);
+      Index index = i * buffers.window_size.width + j;
+      PixelBatch depth =
+          barycentric0 * depth0 + barycentric1 * depth1 + barycentric2 * depth2;
+      PixelBatch stored_depth =
+          PixelBatch::LoadPartial(&z_buffer[index], lanes_count);
+      mask &= Less(depth, stored_depth);
+      if (!mask) {
+        continue;
+      }
+      Select(mask, depth, stored_depth)
+          .StorePartial(&z_buffer[index], lanes_count);
+      if (stats) {
+        stats->pixels_written += std::popcount(mask);
+      }
 
-        Color final_color = MultiplyColor(texture_color, intensity);
+      barycentric0.Store(lane_barycentric0.data());
+      barycentric1.Store(lane_barycentric1.data());
+      barycentric2.Store(lane_barycentric2.data());
+
+      for (Index lane = 0; lane < lanes_count; ++lane) {
+        if (!(mask & (1u << lane))) {
+          continue;
+        }
+        if (visibility_buffer) {
+          (*visibility_buffer)[index + lane] = {
+              .triangle_index = triangle_index,
+              .barycentric = {lane_barycentric0[lane], lane_barycentric1[lane],
+                              lane_barycentric2[lane]}};
+        } else {
+          buffers.pixels[index + lane] = ShadePixel(
+              triangle,
+              {lane_barycentric0[lane], lane_barycentric1[lane],
+               lane_barycentric2[lane], 0},
+              lights);
+        }
+      }
+      written = true;
+    }
+  }
+  return written;
+}
+
+Detail::Color Renderer::ShadePixel(const ScreenTriangle& triangle,
+                                   const Point4& barycentric_point,
+                                   const Lights& lights) const {
+  ElemType intensity = light_manager_.ComputeLightning(
+      {}, triangle.view_triangle, barycentric_point, lights);
+
+  Point4 texture_coord = ConstructTextureCoord(
+      triangle.view_triangle, barycentric_point, triangle.normalize_point);
 
-        DrawPixel(window_size, pixels, z_buffer, {Height(i), Width(j), depth},
-                  final_color);
+  Color texture_color = GetTextureColor(triangle.material, texture_coord);
+
+  return MultiplyColor(texture_color, intensity);
+}
+
+void Renderer::ShadeVisibleTile(const PixelRect& tile_rect,
+                                FrameBuffers& buffers,
+                                const Lights& lights) const {
+  for (Index i = tile_rect.begin_y; i <= tile_rect.end_y; ++i) {
+    for (Index j = tile_rect.begin_x; j <= tile_rect.end_x; ++j) {
+      Index index = i * buffers.window_size.width + j;
+      const VisibilitySample& sample = (*buffers.visibility_buffer)[index];
+      if (sample.triangle_index == VisibilitySample::kEMPTY) {
+        continue;
       }
+      buffers.pixels[index] = ShadePixel(
+          frame_triangles_[sample.triangle_index],
+          {sample.barycentric[0], sample.barycentric[1], sample.barycentric[2],
+           0},
+          lights);
+    }
+  }
+}
+
+void Renderer::AddFrameTriangle(const TriangleData& triangle_data,
+                                const Triangle& clip_vertices,
+                                const Material* const material,
+                                WindowSize window_size, bool needs_clipping) {
+  auto add_triangle = [&](const TriangleData& triangle,
+                          const Triangle& vertices) {
+    ScreenTriangle screen_triangle =
+        SetupTriangle(triangle, vertices, material, window_size);
+    // Degenerate triangles never cover a pixel
+    if (screen_triangle.area != 0) {
+      frame_triangles_.push_back(std::move(screen_triangle));
     }
+  };
+
+  if (!needs_clipping) {
+    add_triangle(triangle_data, clip_vertices);
+    return;
+  }
+
+  Clipper::Polygon polygon;
+  switch (clipper_.Clip(triangle_data, clip_vertices, polygon)) {
+    case Clipper::ClipResult::Outside:
+      return;
+    case Clipper::ClipResult::Inside:
+      add_triangle(triangle_data, clip_vertices);
+      return;
+    case Clipper::ClipResult::Clipped:
+      break;
+  }
+  if constexpr (Detail::kFRAME_STATS_ENABLED) {
+    ++frame_stats_.triangles_clipped;
+  }
+
+  const Clipper::Vertex& pivot = polygon.vertices[0];
+  for (Index i = 1; i + 1 < polygon.size; ++i) {
+    const Clipper::Vertex& second = polygon.vertices[i];
+    const Clipper::Vertex& third = polygon.vertices[i + 1];
+    add_triangle(
+        {Triangle{pivot.position, second.position, third.position},
+         Triangle{pivot.normal, second.normal, third.normal},
+         Triangle{pivot.texture_coord, second.texture_coord,
+                  third.texture_coord},
+         triangle_data.material_index},
+        Triangle{pivot.clip_position, second.clip_position,
+                 third.clip_position});
+  }
+}
+
+void Renderer::PrepareObject(
+    const Object& object, const Camera& camera,
+    const Linear::TransformMatrix4x4& frustum_matrix) {
+  // The frame works relative to the camera, so the camera position is taken
+  // out of the translation before the matrices are concatenated
+  ObjectTransforms transforms{.model_view = object.GetModelMatrix(),
+                              .normal_matrix = object.GetRotation()};
+  Point4 camera_position = camera.GetPosition();
+  for (Index row = 0; row < 3; ++row) {
+    transforms.model_view(row, 3) -= camera_position(row);
+  }
+  transforms.model_view_projection = frustum_matrix * transforms.model_view;
+
+  TransformVertices(object.GetMesh(), transforms, vertex_cache_);
+  CollectFrontFacing(object.GetMesh(), object.ToModelSpace(camera_position),
+                     front_triangles_);
+}
+
+Scene::TriangleData Renderer::AssembleViewTriangle(
+    const Scene::Mesh& mesh, const Scene::MeshTriangle& triangle) const {
+  const Scene::Mesh::Coordinates& view_positions =
+      vertex_cache_.view_positions;
+  const Scene::Mesh::Coordinates& view_normals = vertex_cache_.view_normals;
+  std::array<Scene::MeshVertex, 3> vertices;
+  for (Index i = 0; i < 3; ++i) {
+    Index index = triangle.vertex_indices[i];
+    vertices[i] = mesh.GetVertex(index);
+    vertices[i].position = {view_positions.x[index], view_positions.y[index],
+                            view_positions.z[index], 1};
+    vertices[i].normal = {view_normals.x[index], view_normals.y[index],
+                          view_normals.z[index], 0};
   }
+  return {{vertices[0].position, vertices[1].position, vertices[2].position},
+          {vertices[0].normal, vertices[1].normal, vertices[2].normal},
+          {vertices[0].texture_coord, vertices[1].texture_coord,
+           vertices[2].texture_coord},
+          triangle.material_index};
+}
+
+Linear::Triangle Renderer::AssembleClipTriangle(
+    const Scene::MeshTriangle& triangle) const {
+  Triangle result;
+  for (Index i = 0; i < 3; ++i) {
+    Index index = triangle.vertex_indices[i];
+    result(i) = {vertex_cache_.clip_x[index], vertex_cache_.clip_y[index],
+                 vertex_cache_.clip_z[index], vertex_cache_.clip_w[index]};
+  }
+  return result;
+}
+
+void Renderer::CollectVisibleObjects(const std::vector<Object>& objects,
+                                     const Scene::FrustumPlanes& planes) {
+  for (Index index = 0; index < Index(objects.size()); ++index) {
+    Scene::Containment containment =
+        Scene::TestFrustum(planes, objects[index].GetWorldBoundingSphere());
+    if (containment == Scene::Containment::Intersecting) {
+      containment =
+          Scene::TestFrustum(planes, objects[index].GetWorldBoundingBox());
+    }
+    if (containment != Scene::Containment::Outside) {
+      visible_objects_.push_back({index, containment});
+    }
+  }
+}
+
+void Renderer::CullOccludedObjects(
+    const std::vector<Object>& objects, const Camera& camera,
+    const Linear::TransformMatrix4x4& frustum_matrix, WindowSize window_size) {
+  if (visible_objects_.size() < 2) {
+    return;
+  }
+  Point4 to_camera_space = Point4{0, 0, 0, 1} - camera.GetPosition();
+
+  // Angular size of the bounding sphere picks the occluders
+  occluder_candidates_.clear();
+  for (Index index = 0; index < Index(visible_objects_.size()); ++index) {
+    const Object& object = objects[visible_objects_[index].object_index];
+    if (object.GetTrianglesCount() > kMAX_OCCLUDER_TRIANGLES) {
+      continue;
+    }
+    Scene::BoundingSphere sphere = object.GetWorldBoundingSphere();
+    Point4 to_center = sphere.center - camera.GetPosition();
+    ElemType distance = std::sqrt(Linear::DotProduct(to_center, to_center));
+    occluder_candidates_.emplace_back(
+        sphere.radius / std::max<ElemType>(distance, kEPS), index);
+  }
+  Index occluders_count =
+      std::min<Index>(kMAX_OCCLUDERS, occluder_candidates_.size());
+  std::partial_sort(occluder_candidates_.begin(),
+                    occluder_candidates_.begin() + occluders_count,
+                    occluder_candidates_.end(), std::greater<>());
+
+  occlusion_culler_.Reset(window_size);
+  for (Index candidate = 0; candidate < occluders_count; ++candidate) {
+    Index visible_index = occluder_candidates_[candidate].second;
+    const Object& object = objects[visible_objects_[visible_index].object_index];
+    PrepareObject(object, camera, frustum_matrix);
+
+    for (Index triangle_index : front_triangles_) {
+      Triangle clip_vertices =
+          AssembleClipTriangle(object.GetMesh().triangles[triangle_index]);
+      // Parts of clipped triangles are simply not used as occluders
+      if (clipper_.Classify(clip_vertices) == Clipper::ClipResult::Inside) {
+        occlusion_culler_.RasterizeOccluder(clip_vertices);
+      }
+    }
+  }
+
+  // An occluder never hides itself: its nearest point is in front of every
+  // depth it wrote
+  std::erase_if(visible_objects_, [&](const Scene::VisibleObject& visible) {
+    Scene::BoundingBox box =
+        objects[visible.object_index].GetWorldBoundingBox().Offset(
+            to_camera_space);
+    return occlusion_culler_.IsOccluded(box, frustum_matrix);
+  });
+}
+
+void Renderer::BinTriangles(const RenderTarget& target) {
+  Index tiles_count = target.GetTilesCount();
+  Index tiles_x = target.GetTilesCountX();
+
+  auto for_each_tile = [&](Index index, auto&& action) {
+    const OffsetedVector& box = frame_triangles_[index].bounding_box;
+    if (box.begin(0) > box.end(0) || box.begin(1) > box.end(1)) {
+      return;
+    }
+    Index tile_begin_x = Index(box.begin(0)) / kTILE_SIZE;
+    Index tile_begin_y = Index(box.begin(1)) / kTILE_SIZE;
+    Index tile_end_x = Index(box.end(0)) / kTILE_SIZE;
+    Index tile_end_y = Index(box.end(1)) / kTILE_SIZE;
+
+    for (Index tile_y = tile_begin_y; tile_y <= tile_end_y; ++tile_y) {
+      for (Index tile_x = tile_begin_x; tile_x <= tile_end_x; ++tile_x) {
+        action(tile_y * tiles_x + tile_x);
+      }
+    }
+  };
+
+  // Counting sort into one array, which stops growing once it fits the
+  // busiest frame, unlike a vector per tile. Sizes go one tile up, so that
+  // the prefix sums give where each bin begins.
+  tile_bin_offsets_.assign(tiles_count + 1, 0);
+  Index triangles_count = frame_triangles_.size();
+  for (Index index = 0; index < triangles_count; ++index) {
+    for_each_tile(index, [&](Index tile) { ++tile_bin_offsets_[tile + 1]; });
+  }
+  for (Index tile = 1; tile <= tiles_count; ++tile) {
+    tile_bin_offsets_[tile] += tile_bin_offsets_[tile - 1];
+  }
+  tile_bin_triangles_.resize(tile_bin_offsets_[tiles_count]);
+
+  // Triangles are placed in submission order, so each tile sees them in the
+  // same order as a serial renderer would and depth ties resolve identically.
+  // The offsets serve as cursors, leaving each at the end of its bin.
+  for (Index index = 0; index < triangles_count; ++index) {
+    for_each_tile(index, [&](Index tile) {
+      tile_bin_triangles_[tile_bin_offsets_[tile]++] = index;
+    });
+  }
+  for (Index tile = tiles_count; tile > 0; --tile) {
+    tile_bin_offsets_[tile] = tile_bin_offsets_[tile - 1];
+  }
+  tile_bin_offsets_[0] = 0;
+}
+
+std::span<const Linear::Index> Renderer::GetTileBin(Index tile_index) const {
+  return {tile_bin_triangles_.data() + tile_bin_offsets_[tile_index],
+          tile_bin_triangles_.data() + tile_bin_offsets_[tile_index + 1]};
 }
 
 Detail::ScreenPicture Renderer::RenderScene(const std::vector<Object>& objects,
                                             Camera& camera,
                                             const Lights& lights,
                                             WindowSize window_size) {
-  CameraRatioCheck(camera, window_size);
+  default_target_.Resize(window_size);
+  RenderScene(objects, camera, lights, default_target_);
+  return default_target_.GetPicture();
+}
 
-  Lights view_lights = lights;
-  for (auto& light : view_lights) {
-    light.position -= camera.GetPosition();
+void Renderer::RenderScene(const std::vector<Object>& objects, Camera& camera,
+                           const Lights& lights, RenderTarget& target,
+                           const Scene::BVH* bvh) {
+  using Stage = FrameStats::Stage;
+  using StageTimer = Detail::ScopedStageTimer<>;
+  using StageCounters = Detail::ScopedStageCounters<>;
+  using StagesCounters = std::array<Profiling::PerfCounterValues,
+                                    FrameStats::kSTAGES_COUNT>;
+  constexpr bool kSTATS = Detail::kFRAME_STATS_ENABLED;
+
+  // Counters of the calling thread, null when they are not to be read
+  auto get_perf_counters = [this]() -> const Profiling::ThreadPerfCounters* {
+    if (!kSTATS || !perf_counters_enabled_) {
+      return nullptr;
+    }
+    const auto& counters = Profiling::ThreadPerfCounters::Get();
+    return counters.IsAvailable() ? &counters : nullptr;
+  };
+  const Profiling::ThreadPerfCounters* perf_counters = get_perf_counters();
+
+  if constexpr (kSTATS) {
+    frame_stats_ = {};
+    frame_stats_.has_perf_counters = perf_counters != nullptr;
   }
+  std::array<double, FrameStats::kSTAGES_COUNT>& stage_milliseconds =
+      frame_stats_.stage_milliseconds;
+  StagesCounters& stage_counters = frame_stats_.stage_counters;
+  StageTimer frame_timer(frame_stats_.frame_milliseconds);
+  TRACE_SCOPE("RenderScene");
 
-  ScreenPicture pixels(window_size.width * window_size.height, 0x000000);
-  ZBuffer z_buf(window_size.width * window_size.height, kMAX_Z_DEPTH);
+  WindowSize window_size = target.GetWindowSize();
+  CameraRatioCheck(camera, window_size);
 
-  Scene::FrustumPlanes frustum_planes = camera.GetFrustumPlanes();
+  // Assigning keeps the capacity of the previous frame
+  view_lights_ = lights;
+  for (auto& light : view_lights_) {
+    light.position -= camera.GetPosition();
+  }
 
-  for (auto object : objects) {
-    // Clipping
-    std::queue<Scene::TriangleData> clipping_pool;
-    for (auto index = 0; index < object.GetTrianglesCount(); ++index) {
-      TriangleData triangle_data = object(index);
-      triangle_data.vertices.OffsetCoords(object.GetPosition() -
-                                          camera.GetPosition());
+  FrameBuffers buffers{.window_size = window_size,
+                       .pixels = target.GetPixels(),
+                       .z_buffer = target.GetZBuffer(),
+                       .hierarchical_z = &target.GetHierarchicalZ()};
+  if (shading_mode_ == ShadingMode::Deferred) {
+    buffers.visibility_buffer = &target.GetVisibilityBuffer();
+  }
 
-      if (!IsBackfaceCulled(triangle_data, camera)) {
-        clipping_pool.push(triangle_data);
-      }
+  Linear::TransformMatrix4x4 frustum_matrix = camera.GetFullFrustumMatrix();
+  {
+    StageTimer timer(stage_milliseconds[Stage::kCULLING]);
+    StageCounters counters(perf_counters, stage_counters[Stage::kCULLING]);
+    TRACE_SCOPE("culling");
+    // Whole-object culling before any per-triangle work
+    Scene::FrustumPlanes frustum_planes = Scene::OffsetFrustum(
+        camera.GetFrustumPlanes(), camera.GetPosition() - Point4{0, 0, 0, 1});
+    visible_objects_.clear();
+    if (bvh && bvh->GetObjectsCount() == Index(objects.size())) {
+      bvh->CollectVisible(frustum_planes, visible_objects_);
+    } else {
+      CollectVisibleObjects(objects, frustum_planes);
+    }
+    Index in_frustum_count = visible_objects_.size();
+    if (occlusion_culling_enabled_) {
+      CullOccludedObjects(objects, camera, frustum_matrix, window_size);
     }
+    if constexpr (kSTATS) {
+      frame_stats_.objects_in = objects.size();
+      frame_stats_.objects_frustum_culled = objects.size() - in_frustum_count;
+      frame_stats_.objects_occluded =
+          in_frustum_count - visible_objects_.size();
+    }
+  }
 
-    ClipTrianglesThroughPlane(frustum_planes.near, clipping_pool);
-    ClipTrianglesThroughPlane(frustum_planes.far, clipping_pool);
+  frame_triangles_.clear();
+  for (const auto& visible_object : visible_objects_) {
+    const Object& object = objects[visible_object.object_index];
+    bool needs_clipping =
+        visible_object.containment != Scene::Containment::Inside;
+    {
+      StageTimer timer(stage_milliseconds[Stage::kVERTEX_PROCESSING]);
+      StageCounters counters(perf_counters,
+                             stage_counters[Stage::kVERTEX_PROCESSING]);
+      TRACE_SCOPE_ARG("vertex processing", "object",
+                      visible_object.object_index);
+      PrepareObject(object, camera, frustum_matrix);
+    }
+    if constexpr (kSTATS) {
+      frame_stats_.triangles_in += object.GetTrianglesCount();
+      frame_stats_.triangles_backface_culled +=
+          object.GetTrianglesCount() - front_triangles_.size();
+    }
 
-    ClipTrianglesThroughPlane(frustum_planes.up, clipping_pool);
-    ClipTrianglesThroughPlane(frustum_planes.down, clipping_pool);
+    StageTimer timer(stage_milliseconds[Stage::kTRIANGLE_SETUP]);
+    StageCounters counters(perf_counters,
+                           stage_counters[Stage::kTRIANGLE_SETUP]);
+    TRACE_SCOPE_ARG("triangle setup", "object", visible_object.object_index);
+    for (Index triangle_index : front_triangles_) {
+      const Scene::MeshTriangle& mesh_triangle =
+          object.GetMesh().triangles[triangle_index];
+      TriangleData triangle_data =
+          AssembleViewTriangle(object.GetMesh(), mesh_triangle);
+      AddFrameTriangle(triangle_data, AssembleClipTriangle(mesh_triangle),
+                       object.GetMaterial(triangle_data.material_index),
+                       window_size, needs_clipping);
+    }
+  }
 
-    ClipTrianglesThroughPlane(frustum_planes.left, clipping_pool);
-    ClipTrianglesThroughPlane(frustum_planes.right, clipping_pool);
+  {
+    StageTimer timer(stage_milliseconds[Stage::kBINNING]);
+    StageCounters counters(perf_counters, stage_counters[Stage::kBINNING]);
+    TRACE_SCOPE("binning");
+    // Sort-middle rasterization: every tile owns its part of the color and
+    // depth buffers, so tiles are rasterized in parallel without locks.
+    BinTriangles(target);
+  }
 
-    std::vector<TriangleData> clipped_triangles;
-    while (!clipping_pool.empty()) {
-      clipped_triangles.push_back(std::move(clipping_pool.front()));
-      clipping_pool.pop();
+  if constexpr (kSTATS) {
+    // Tiles count into their own statistics, summed up after the frame
+    tile_stats_.assign(target.GetTilesCount(), {});
+  }
+  thread_pool_.ParallelFor(target.GetTilesCount(), [&](Index tile_index) {
+    PixelRect tile_rect = target.GetTileRect(tile_index);
+    FrameBuffers tile_buffers = buffers;
+    if constexpr (kSTATS) {
+      tile_buffers.stats = &tile_stats_[tile_index];
+    }
+    std::array<double, FrameStats::kSTAGES_COUNT>& tile_milliseconds =
+        kSTATS ? tile_stats_[tile_index].stage_milliseconds
+               : stage_milliseconds;
+    StagesCounters& tile_counters =
+        kSTATS ? tile_stats_[tile_index].stage_counters : stage_counters;
+    const Profiling::ThreadPerfCounters* tile_perf_counters =
+        perf_counters ? get_perf_counters() : nullptr;
+
+    {
+      StageTimer timer(tile_milliseconds[Stage::kRASTERIZATION]);
+      StageCounters counters(tile_perf_counters,
+                             tile_counters[Stage::kRASTERIZATION]);
+      TRACE_SCOPE_ARG("rasterize tile", "tile", tile_index);
+      // Clearing here rather than up front keeps it parallel and leaves the
+      // tile in cache for rasterization
+      target.ClearTile(tile_index);
+      std::span<const Index> tile_bin = GetTileBin(tile_index);
+      target.SetTileWritten(tile_index, !tile_bin.empty());
+
+      for (Index triangle_index : tile_bin) {
+        RasterizeTriangle(frame_triangles_[triangle_index], triangle_index,
+                          tile_rect, tile_buffers, view_lights_);
+      }
     }
 
-    // Draw triangles
-    for (auto& triangle_data : clipped_triangles) {
-      RasterizeTriangle(triangle_data,
-                        object.GetMaterial(triangle_data.material_index),
-                        camera, window_size, pixels, z_buf, view_lights);
+    if (buffers.visibility_buffer) {
+      StageTimer timer(tile_milliseconds[Stage::kSHADING]);
+      StageCounters counters(tile_perf_counters,
+                             tile_counters[Stage::kSHADING]);
+      TRACE_SCOPE_ARG("shade tile", "tile", tile_index);
+      ShadeVisibleTile(tile_rect, tile_buffers, view_lights_);
+    }
+  });
+
+  if constexpr (kSTATS) {
+    frame_stats_.triangles_emitted = frame_triangles_.size();
+    frame_stats_.screen_pixels =
+        uint64_t(window_size.width) * uint64_t(window_size.height);
+    for (const FrameStats& tile_stats : tile_stats_) {
+      for (Index stage : {Stage::kRASTERIZATION, Stage::kSHADING}) {
+        stage_milliseconds[stage] += tile_stats.stage_milliseconds[stage];
+        stage_counters[stage] += tile_stats.stage_counters[stage];
+      }
+      frame_stats_.pixels_tested += tile_stats.pixels_tested;
+      frame_stats_.pixels_written += tile_stats.pixels_written;
     }
   }
+}
+
+ShadingMode Renderer::GetShadingMode() const {
+  return shading_mode_;
+}
+
+void Renderer::SetShadingMode(ShadingMode new_mode) {
+  shading_mode_ = new_mode;
+}
+
+bool Renderer::IsOcclusionCullingEnabled() const {
+  return occlusion_culling_enabled_;
+}
+
+void Renderer::SetOcclusionCullingEnabled(bool enabled) {
+  occlusion_culling_enabled_ = enabled;
+}
+
+Linear::Index Renderer::GetThreadsCount() const {
+  return thread_pool_.GetThreadsCount();
+}
+
+void Renderer::SetThreadsCount(Index threads_count) {
+  thread_pool_.SetThreadsCount(threads_count);
+}
+
+const Detail::FrameStats& Renderer::GetFrameStats() const {
+  return frame_stats_;
+}
+
+bool Renderer::IsPerfCountersEnabled() const {
+  return perf_counters_enabled_;
+}
+
+void Renderer::SetPerfCountersEnabled(bool enabled) {
+  perf_counters_enabled_ = enabled;
+}
+
+bool Renderer::IsSimdEnabled() const {
+  return simd_enabled_;
+}
 
-  return pixels;
+void Renderer::SetSimdEnabled(bool enabled) {
+  simd_enabled_ = enabled;
 }
 
 Linear::Detail::Width Renderer::ConvertToScreenX(WindowSize window_size,
                                                  const Point4& point) {
-  return Width{
-      static_cast<int>((point(0) + 1.0) * 0.5 * (window_size.width - 1))};
+  // Rounded down rather than toward zero, so that vertices left of the
+  // screen in the guard band snap like the ones on it
+  return Width{static_cast<int>(
+      std::floor((point(0) + 1.0) * 0.5 * (window_size.width - 1)))};
 };
 
 Linear::Detail::Height Renderer::ConvertToScreenY(WindowSize window_size,
                                                   const Point4& point) {
-  return Height{static_cast<int>((1.0 - (point(1) + 1.0) * 0.5) *
-                                 (window_size.height - 1))};
+  return Height{static_cast<int>(
+      std::floor((1.0 - (point(1) + 1.0) * 0.5) * (window_size.height - 1)))};
 };
 
 Linear::OffsetedVector Renderer::GetBoundingBoxBorders(
-    const TriangleData& triangle_data, WindowSize window_size) {
-  Point4 begin{std::max(0.0, std::min({triangle_data.vertices(0)(0),
-                                       triangle_data.vertices(1)(0),
-                                       triangle_data.vertices(2)(0)})),
-               std::max(0.0, std::min({triangle_data.vertices(0)(1),
-                                       triangle_data.vertices(1)(1),
-                                       triangle_data.vertices(2)(1)})),
+    const Triangle& vertices, WindowSize window_size) {
+  Point4 begin{std::max<ElemType>(0, std::min({vertices(0)(0), vertices(1)(0),
+                                                vertices(2)(0)})),
+               std::max<ElemType>(0, std::min({vertices(0)(1), vertices(1)(1),
+                                                vertices(2)(1)})),
                0, 0};
-  Point4 end{std::min(window_size.width - 1.0,
-                      std::max({triangle_data.vertices(0)(0),
-                                triangle_data.vertices(1)(0),
-                                triangle_data.vertices(2)(0)})),
-             std::min(window_size.height - 1.0,
-                      std::max({triangle_data.vertices(0)(1),
-                                triangle_data.vertices(1)(1),
-                                triangle_data.vertices(2)(1)})),
+  Point4 end{std::min<ElemType>(window_size.width - 1,
+                                std::max({vertices(0)(0), vertices(1)(0),
+                                          vertices(2)(0)})),
+             std::min<ElemType>(window_size.height - 1,
+                                std::max({vertices(0)(1), vertices(1)(1),
+                                          vertices(2)(1)})),
              0, 0};
   return {begin, end};
 }
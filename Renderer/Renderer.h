@@ -1,12 +1,21 @@
 #pragma once
 
-#include <queue>
+#include <array>
+#include <span>
 #include <vector>
+#include "../Detail/FrameStats.h"
 #include "../Detail/Palette.h"
 #include "../MathUtils/Plane.h"
+#include "../Object/BVH.h"
 #include "../Object/Camera.h"
 #include "../Object/Object.h"
+#include "Clipper.h"
+#include "HierarchicalZ.h"
 #include "LightManager.h"
+#include "OcclusionCuller.h"
+#include "RenderTarget.h"
+#include "ThreadPool.h"
+#include "VertexProcessing.h"
 
 namespace Core {
 
@@ -22,13 +31,57 @@ namespace Rendering {
 static constexpr double kDEFAULT_AMBIENT = 0.2;
 static constexpr double kDEFAULT_DIFFUSE = 0.8;
 
-class Renderer {
+// Signed doubled area of the triangle (begin, end, point) as an affine
+// function of the point, i.e. Triangle{begin, end, point}.GetAreaXYProjection()
+// evaluated incrementally.
+struct EdgeFunction {
+  using ElemType = Linear::ElemType;
+  using Point4 = Linear::Point4;
+
+  EdgeFunction(const Point4& begin, const Point4& end)
+      : begin_x(begin(0)),
+        begin_y(begin(1)),
+        step_x(begin(1) - end(1)),
+        step_y(end(0) - begin(0)) {
+  }
+
+  ElemType Evaluate(ElemType x, ElemType y) const {
+    return step_y * (y - begin_y) + step_x * (x - begin_x);
+  }
+
+  ElemType begin_x;
+  ElemType begin_y;
+  ElemType step_x;
+  ElemType step_y;
+};
+
+// Triangle after the frustum transform and viewport mapping, ready to be
+// rasterized into any part of the screen.
+struct ScreenTriangle {
   using ElemType = Linear::ElemType;
   using Point4 = Linear::Point4;
   using Triangle = Linear::Triangle;
 
-  using Plane = Linear::Plane;
-  using IntersectionResult = Linear::IntersectionResult;
+  // Camera-relative triangle, used for lighting and texturing
+  Scene::TriangleData view_triangle;
+
+  Triangle screen_vertices;
+  Point4 normalize_point{};
+  ElemType area = 0;
+  Linear::OffsetedVector bounding_box{};
+
+  const Detail::Material* material = nullptr;
+};
+
+// Forward mode shades every fragment that passes the depth test at the time
+// it is rasterized. Deferred mode first resolves visibility for the whole
+// tile and then shades each visible pixel exactly once.
+enum class ShadingMode { Forward, Deferred };
+
+class Renderer {
+  using ElemType = Linear::ElemType;
+  using Point4 = Linear::Point4;
+  using Triangle = Linear::Triangle;
 
   using Camera = Scene::Camera;
   using Object = Scene::Object;
@@ -48,6 +101,7 @@ class Renderer {
 
   using WindowSize = Detail::WindowSize;
   using Lights = Detail::Lights;
+  using FrameStats = Detail::FrameStats;
 
 public:
   void CameraRatioCheck(Camera& camera, WindowSize window_size);
@@ -57,7 +111,7 @@ public:
   Point4 ComputeBarycentric(const Point4& point, const Triangle& triangle,
                             const ElemType& triangle_area);
 
-  ElemType MultiplyColor(const Color& color, const ElemType& scalar);
+  Color MultiplyColor(const Color& color, const ElemType& scalar) const;
 
   Linear::Point4 ConstructTextureCoord(const TriangleData& triangle_data,
                                        const Point4& barycentric_point,
@@ -66,9 +120,6 @@ public:
   Color GetTextureColor(const Material* const material,
                         const Point4& texture_coord) const;
 
-  void ClipTrianglesThroughPlane(const Plane& plane,
-                                 std::queue<TriangleData>& triangle_pool);
-
   void DrawPixel(const WindowSize& window_size, ScreenPicture& pixels,
                  ZBuffer& z_buffer, const ScreenPoint& location, Color color);
 
@@ -79,6 +130,16 @@ public:
   void DrawBorder(const TriangleData& triangle, const WindowSize& window_size,
                   ScreenPicture& pixels, ZBuffer& z_buffer, Color color);
 
+  ScreenTriangle SetupTriangle(const TriangleData& triangle_data,
+                               const Material* const material,
+                               const Camera& camera, WindowSize window_size);
+
+  // Same as above for a triangle already transformed into clip space
+  ScreenTriangle SetupTriangle(const TriangleData& triangle_data,
+                               const Triangle& clip_vertices,
+                               const Material* const material,
+                               WindowSize window_size);
+
   void RasterizeTriangle(TriangleData& triangle_data,
                          const Material* const material, const Camera& camera,
                          WindowSize window_size, ScreenPicture& pixels,
@@ -87,19 +148,149 @@ public:
   ScreenPicture RenderScene(const std::vector<Object>& objects, Camera& camera,
                             const Lights& lights, WindowSize window_size);
 
+  // Renders into the target, whose buffers are reused from the previous
+  // frame. With a hierarchy built over objects, culling traverses it instead
+  // of testing every object.
+  void RenderScene(const std::vector<Object>& objects, Camera& camera,
+                   const Lights& lights, RenderTarget& target,
+                   const Scene::BVH* bvh = nullptr);
+
+  ShadingMode GetShadingMode() const;
+  void SetShadingMode(ShadingMode new_mode);
+
+  bool IsOcclusionCullingEnabled() const;
+  void SetOcclusionCullingEnabled(bool enabled);
+
+  // Threads rendering the tiles of a frame, the calling thread included
+  Index GetThreadsCount() const;
+  void SetThreadsCount(Index threads_count);
+
+  // Statistics of the last RenderScene call, all zero unless the renderer is
+  // built with RENDERER_FRAME_STATS
+  const FrameStats& GetFrameStats() const;
+
+  // Reads hardware performance counters around every stage into the frame
+  // statistics, at the cost of two system calls per stage and tile. Off by
+  // default, and without effect where the counters are not granted.
+  bool IsPerfCountersEnabled() const;
+  void SetPerfCountersEnabled(bool enabled);
+
+  // Evaluates pixels in SIMD batches. When off, the same kernel runs one
+  // pixel at a time; both produce identical images.
+  bool IsSimdEnabled() const;
+  void SetSimdEnabled(bool enabled);
+
 private:
   static constexpr ElemType kEPS = 1e-6;
   static constexpr Color kBORDER_COLOR = 0x008000;
   static constexpr Color kDEFAULT_COLOR = 0xFFFFFFFF;
   static constexpr ZDepth kMAX_Z_DEPTH = 0xFFFFFF;
+  static constexpr Index kTILE_SIZE = RenderTarget::kTILE_SIZE;
+  // Slack for rounding in the conservative depth bounds of coarse rejection
+  static constexpr ElemType kHIZ_EPS = 1e-5;
+  // Occluders are meant to be walls and other large, simple objects
+  static constexpr Index kMAX_OCCLUDERS = 8;
+  static constexpr Index kMAX_OCCLUDER_TRIANGLES = 256;
+
+  // Color, depth and visibility buffers a triangle is rasterized into. The
+  // pyramid and the visibility buffer are optional.
+  struct FrameBuffers {
+    WindowSize window_size;
+    Color* pixels;
+    ZBuffer& z_buffer;
+    HierarchicalZ* hierarchical_z = nullptr;
+    VisibilityBuffer* visibility_buffer = nullptr;
+    // Statistics of the tile being rasterized, with the stats enabled
+    FrameStats* stats = nullptr;
+  };
+
+  // Rasterizes the part of the triangle inside clip_rect. With a pyramid,
+  // hidden parts are rejected per 8x8 block and the pyramid is kept up to
+  // date. With a visibility buffer, covered pixels record triangle_index and
+  // their barycentric coordinates instead of being shaded.
+  void RasterizeTriangle(const ScreenTriangle& triangle, Index triangle_index,
+                         const PixelRect& clip_rect, FrameBuffers& buffers,
+                         const Lights& lights);
+
+  // Returns whether any pixel of the block was written. PixelBatch is the
+  // batch type of SimdBatch.h the pixels are evaluated with.
+  template <typename PixelBatch>
+  bool RasterizeBlock(const ScreenTriangle& triangle, Index triangle_index,
+                      const std::array<EdgeFunction, 3>& edges,
+                      const PixelRect& rect, FrameBuffers& buffers,
+                      const Lights& lights);
 
-  OffsetedVector GetBoundingBoxBorders(const TriangleData& triangle,
+  Color ShadePixel(const ScreenTriangle& triangle,
+                   const Point4& barycentric_point, const Lights& lights) const;
+
+  // Second pass of the deferred mode
+  void ShadeVisibleTile(const PixelRect& tile_rect, FrameBuffers& buffers,
+                        const Lights& lights) const;
+
+  OffsetedVector GetBoundingBoxBorders(const Triangle& vertices,
                                        WindowSize window_size);
 
   Width ConvertToScreenX(WindowSize window_size, const Point4& point);
   Height ConvertToScreenY(WindowSize window_size, const Point4& point);
 
+  // Clips the camera-relative triangle, unless its object is known to be
+  // inside the frustum, and appends the visible parts to the frame triangles
+  void AddFrameTriangle(const TriangleData& triangle_data,
+                        const Triangle& clip_vertices,
+                        const Material* const material,
+                        WindowSize window_size, bool needs_clipping);
+
+  // Transforms the object's vertices into vertex_cache_ and collects its
+  // triangles facing the camera into front_triangles_
+  void PrepareObject(const Object& object, const Camera& camera,
+                     const Linear::TransformMatrix4x4& frustum_matrix);
+
+  // Camera-relative triangle and its clip-space vertices from vertex_cache_
+  TriangleData AssembleViewTriangle(const Scene::Mesh& mesh,
+                                    const Scene::MeshTriangle& triangle) const;
+  Triangle AssembleClipTriangle(const Scene::MeshTriangle& triangle) const;
+
+  // Fills visible_objects_ by testing objects one by one against world-space
+  // planes
+  void CollectVisibleObjects(const std::vector<Object>& objects,
+                             const Scene::FrustumPlanes& planes);
+
+  // Rasterizes the objects closest to covering the screen as occluders and
+  // removes the visible objects hidden behind them
+  void CullOccludedObjects(const std::vector<Object>& objects,
+                           const Camera& camera,
+                           const Linear::TransformMatrix4x4& frustum_matrix,
+                           WindowSize window_size);
+
+  void BinTriangles(const RenderTarget& target);
+  // Indices of the frame triangles overlapping the tile
+  std::span<const Index> GetTileBin(Index tile_index) const;
+
   LightManager light_manager_;
+  Clipper clipper_;
+  ThreadPool thread_pool_;
+  ShadingMode shading_mode_ = ShadingMode::Forward;
+  OcclusionCuller occlusion_culler_;
+  bool occlusion_culling_enabled_ = true;
+  bool perf_counters_enabled_ = false;
+  bool simd_enabled_ = true;
+
+  // Per-frame storage, kept between frames to reuse the allocations
+  Lights view_lights_;
+  std::vector<Scene::VisibleObject> visible_objects_;
+  // Visible objects as (projected size, position in visible_objects_)
+  std::vector<std::pair<ElemType, Index>> occluder_candidates_;
+  TransformedVertices vertex_cache_;
+  std::vector<Index> front_triangles_;
+  std::vector<ScreenTriangle> frame_triangles_;
+  // Bins of all tiles in one array: tile i owns the triangles from
+  // tile_bin_offsets_[i] up to tile_bin_offsets_[i + 1]
+  std::vector<Index> tile_bin_offsets_;
+  std::vector<Index> tile_bin_triangles_;
+  std::vector<FrameStats> tile_stats_;
+  FrameStats frame_stats_;
+  // Target of the RenderScene overload that returns the picture
+  RenderTarget default_target_;
 };
 
 }  // namespace Rendering
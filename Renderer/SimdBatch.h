@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "../MathUtils/Matrix.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Private to the Renderer sources: the layout of Batch depends on the
+// instruction sets enabled for the translation unit.
+
+namespace Rendering {
+
+// Lanes of the widest batch of T the enabled instruction sets provide
+template <typename T>
+inline constexpr Linear::Index kNATIVE_WIDTH = 1;
+
+#if defined(__AVX__)
+template <>
+inline constexpr Linear::Index kNATIVE_WIDTH<double> = 4;
+template <>
+inline constexpr Linear::Index kNATIVE_WIDTH<float> = 8;
+#elif defined(__SSE2__)
+// Two registers per batch, so that double runs as many lanes as float
+template <>
+inline constexpr Linear::Index kNATIVE_WIDTH<double> = 4;
+template <>
+inline constexpr Linear::Index kNATIVE_WIDTH<float> = 4;
+#endif
+
+// Pack of kLANES horizontally adjacent pixel values processed by the pixel
+// kernel. The one-lane batch is the scalar fallback and the reference the
+// wider specializations are tested against. Lane masks are returned as bit
+// sets with bit i standing for lane i.
+template <typename T, Linear::Index kLANES = kNATIVE_WIDTH<T>>
+struct Batch;
+
+template <typename T>
+struct Batch<T, 1> {
+  using Index = Linear::Index;
+  using Mask = unsigned;
+
+  static constexpr Index kWIDTH = 1;
+
+  static Batch Broadcast(T elem) {
+    return {elem};
+  }
+  // Lane i holds i * step
+  static Batch Ramp(T step) {
+    return {T(0) * step};
+  }
+  // Loads the first lanes_count lanes; the others are left unspecified
+  static Batch LoadPartial(const T* source, Index lanes_count) {
+    return {lanes_count > 0 ? source[0] : T()};
+  }
+
+  void Store(T* destination) const {
+    destination[0] = value;
+  }
+  // Stores the first lanes_count lanes only
+  void StorePartial(T* destination, Index lanes_count) const {
+    if (lanes_count > 0) {
+      destination[0] = value;
+    }
+  }
+
+  Batch operator+(Batch other) const {
+    return {value + other.value};
+  }
+  Batch operator*(Batch other) const {
+    return {value * other.value};
+  }
+  Batch operator/(Batch other) const {
+    return {value / other.value};
+  }
+
+  friend Mask GreaterEqual(Batch lhs, Batch rhs) {
+    return lhs.value >= rhs.value;
+  }
+  friend Mask Less(Batch lhs, Batch rhs) {
+    return lhs.value < rhs.value;
+  }
+  // Lanes of if_set where the mask bit is set, of otherwise elsewhere
+  friend Batch Select(Mask mask, Batch if_set, Batch otherwise) {
+    return mask & 1u ? if_set : otherwise;
+  }
+
+  T value;
+};
+
+#if defined(__AVX__)
+
+template <>
+struct Batch<double, 4> {
+  using Index = Linear::Index;
+  using Mask = unsigned;
+
+  static constexpr Index kWIDTH = 4;
+
+  static Batch Broadcast(double elem) {
+    return {_mm256_set1_pd(elem)};
+  }
+  static Batch Ramp(double step) {
+    return {_mm256_setr_pd(0 * step, 1 * step, 2 * step, 3 * step)};
+  }
+  static Batch LoadPartial(const double* source, Index lanes_count) {
+    if (lanes_count >= kWIDTH) {
+      return {_mm256_loadu_pd(source)};
+    }
+    alignas(32) std::array<double, kWIDTH> lanes{};
+    std::copy(source, source + lanes_count, lanes.begin());
+    return {_mm256_load_pd(lanes.data())};
+  }
+
+  void Store(double* destination) const {
+    _mm256_storeu_pd(destination, value);
+  }
+  void StorePartial(double* destination, Index lanes_count) const {
+    _mm256_maskstore_pd(destination, LanesMask(lanes_count), value);
+  }
+
+  Batch operator+(Batch other) const {
+    return {_mm256_add_pd(value, other.value)};
+  }
+  Batch operator*(Batch other) const {
+    return {_mm256_mul_pd(value, other.value)};
+  }
+  Batch operator/(Batch other) const {
+    return {_mm256_div_pd(value, other.value)};
+  }
+
+  friend Mask GreaterEqual(Batch lhs, Batch rhs) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs.value, rhs.value, _CMP_GE_OQ));
+  }
+  friend Mask Less(Batch lhs, Batch rhs) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs.value, rhs.value, _CMP_LT_OQ));
+  }
+  friend Batch Select(Mask mask, Batch if_set, Batch otherwise) {
+    __m256d lanes = _mm256_castsi256_pd(_mm256_setr_epi64x(
+        -int64_t(mask & 1u), -int64_t(mask >> 1 & 1u),
+        -int64_t(mask >> 2 & 1u), -int64_t(mask >> 3 & 1u)));
+    return {_mm256_blendv_pd(otherwise.value, if_set.value, lanes)};
+  }
+
+  __m256d value;
+
+private:
+  // All bits set in the first lanes_count lanes
+  static __m256i LanesMask(Index lanes_count) {
+    return _mm256_setr_epi64x(-int64_t(lanes_count > 0),
+                              -int64_t(lanes_count > 1),
+                              -int64_t(lanes_count > 2),
+                              -int64_t(lanes_count > 3));
+  }
+};
+
+template <>
+struct Batch<float, 8> {
+  using Index = Linear::Index;
+  using Mask = unsigned;
+
+  static constexpr Index kWIDTH = 8;
+
+  static Batch Broadcast(float elem) {
+    return {_mm256_set1_ps(elem)};
+  }
+  static Batch Ramp(float step) {
+    return {_mm256_setr_ps(0 * step, 1 * step, 2 * step, 3 * step, 4 * step,
+                           5 * step, 6 * step, 7 * step)};
+  }
+  static Batch LoadPartial(const float* source, Index lanes_count) {
+    if (lanes_count >= kWIDTH) {
+      return {_mm256_loadu_ps(source)};
+    }
+    alignas(32) std::array<float, kWIDTH> lanes{};
+    std::copy(source, source + lanes_count, lanes.begin());
+    return {_mm256_load_ps(lanes.data())};
+  }
+
+  void Store(float* destination) const {
+    _mm256_storeu_ps(destination, value);
+  }
+  void StorePartial(float* destination, Index lanes_count) const {
+    _mm256_maskstore_ps(destination, LanesMask(lanes_count), value);
+  }
+
+  Batch operator+(Batch other) const {
+    return {_mm256_add_ps(value, other.value)};
+  }
+  Batch operator*(Batch other) const {
+    return {_mm256_mul_ps(value, other.value)};
+  }
+  Batch operator/(Batch other) const {
+    return {_mm256_div_ps(value, other.value)};
+  }
+
+  friend Mask GreaterEqual(Batch lhs, Batch rhs) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(lhs.value, rhs.value, _CMP_GE_OQ));
+  }
+  friend Mask Less(Batch lhs, Batch rhs) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(lhs.value, rhs.value, _CMP_LT_OQ));
+  }
+  friend Batch Select(Mask mask, Batch if_set, Batch otherwise) {
+    __m256 lanes = _mm256_castsi256_ps(_mm256_setr_epi32(
+        -int32_t(mask & 1u), -int32_t(mask >> 1 & 1u),
+        -int32_t(mask >> 2 & 1u), -int32_t(mask >> 3 & 1u),
+        -int32_t(mask >> 4 & 1u), -int32_t(mask >> 5 & 1u),
+        -int32_t(mask >> 6 & 1u), -int32_t(mask >> 7 & 1u)));
+    return {_mm256_blendv_ps(otherwise.value, if_set.value, lanes)};
+  }
+
+  __m256 value;
+
+private:
+  static __m256i LanesMask(Index lanes_count) {
+    return _mm256_setr_epi32(
+        -int32_t(lanes_count > 0), -int32_t(lanes_count > 1),
+        -int32_t(lanes_count > 2), -int32_t(lanes_count > 3),
+        -int32_t(lanes_count > 4), -int32_t(lanes_count > 5),
+        -int32_t(lanes_count > 6), -int32_t(lanes_count > 7));
+  }
+};
+
+#elif defined(__SSE2__)
+
+template <>
+struct Batch<double, 4> {
+  using Index = Linear::Index;
+  using Mask = unsigned;
+
+  static constexpr Index kWIDTH = 4;
+
+  static Batch Broadcast(double elem) {
+    __m128d lanes = _mm_set1_pd(elem);
+    return {lanes, lanes};
+  }
+  static Batch Ramp(double step) {
+    return {_mm_setr_pd(0 * step, 1 * step), _mm_setr_pd(2 * step, 3 * step)};
+  }
+  static Batch LoadPartial(const double* source, Index lanes_count) {
+    if (lanes_count >= kWIDTH) {
+      return {_mm_loadu_pd(source), _mm_loadu_pd(source + 2)};
+    }
+    alignas(16) std::array<double, kWIDTH> lanes{};
+    std::copy(source, source + lanes_count, lanes.begin());
+    return {_mm_load_pd(lanes.data()), _mm_load_pd(lanes.data() + 2)};
+  }
+
+  void Store(double* destination) const {
+    _mm_storeu_pd(destination, low);
+    _mm_storeu_pd(destination + 2, high);
+  }
+  void StorePartial(double* destination, Index lanes_count) const {
+    if (lanes_count >= kWIDTH) {
+      Store(destination);
+      return;
+    }
+    alignas(16) std::array<double, kWIDTH> lanes;
+    Store(lanes.data());
+    std::copy(lanes.begin(), lanes.begin() + lanes_count, destination);
+  }
+
+  Batch operator+(Batch other) const {
+    return {_mm_add_pd(low, other.low), _mm_add_pd(high, other.high)};
+  }
+  Batch operator*(Batch other) const {
+    return {_mm_mul_pd(low, other.low), _mm_mul_pd(high, other.high)};
+  }
+  Batch operator/(Batch other) const {
+    return {_mm_div_pd(low, other.low), _mm_div_pd(high, other.high)};
+  }
+
+  friend Mask GreaterEqual(Batch lhs, Batch rhs) {
+    return _mm_movemask_pd(_mm_cmpge_pd(lhs.low, rhs.low)) |
+           _mm_movemask_pd(_mm_cmpge_pd(lhs.high, rhs.high)) << 2;
+  }
+  friend Mask Less(Batch lhs, Batch rhs) {
+    return _mm_movemask_pd(_mm_cmplt_pd(lhs.low, rhs.low)) |
+           _mm_movemask_pd(_mm_cmplt_pd(lhs.high, rhs.high)) << 2;
+  }
+  friend Batch Select(Mask mask, Batch if_set, Batch otherwise) {
+    __m128d low_lanes = _mm_castsi128_pd(
+        _mm_set_epi64x(-int64_t(mask >> 1 & 1u), -int64_t(mask & 1u)));
+    __m128d high_lanes = _mm_castsi128_pd(
+        _mm_set_epi64x(-int64_t(mask >> 3 & 1u), -int64_t(mask >> 2 & 1u)));
+    return {_mm_or_pd(_mm_and_pd(low_lanes, if_set.low),
+                      _mm_andnot_pd(low_lanes, otherwise.low)),
+            _mm_or_pd(_mm_and_pd(high_lanes, if_set.high),
+                      _mm_andnot_pd(high_lanes, otherwise.high))};
+  }
+
+  __m128d low;
+  __m128d high;
+};
+
+template <>
+struct Batch<float, 4> {
+  using Index = Linear::Index;
+  using Mask = unsigned;
+
+  static constexpr Index kWIDTH = 4;
+
+  static Batch Broadcast(float elem) {
+    return {_mm_set1_ps(elem)};
+  }
+  static Batch Ramp(float step) {
+    return {_mm_setr_ps(0 * step, 1 * step, 2 * step, 3 * step)};
+  }
+  static Batch LoadPartial(const float* source, Index lanes_count) {
+    if (lanes_count >= kWIDTH) {
+      return {_mm_loadu_ps(source)};
+    }
+    alignas(16) std::array<float, kWIDTH> lanes{};
+    std::copy(source, source + lanes_count, lanes.begin());
+    return {_mm_load_ps(lanes.data())};
+  }
+
+  void Store(float* destination) const {
+    _mm_storeu_ps(destination, value);
+  }
+  void StorePartial(float* destination, Index lanes_count) const {
+    if (lanes_count >= kWIDTH) {
+      Store(destination);
+      return;
+    }
+    alignas(16) std::array<float, kWIDTH> lanes;
+    Store(lanes.data());
+    std::copy(lanes.begin(), lanes.begin() + lanes_count, destination);
+  }
+
+  Batch operator+(Batch other) const {
+    return {_mm_add_ps(value, other.value)};
+  }
+  Batch operator*(Batch other) const {
+    return {_mm_mul_ps(value, other.value)};
+  }
+  Batch operator/(Batch other) const {
+    return {_mm_div_ps(value, other.value)};
+  }
+
+  friend Mask GreaterEqual(Batch lhs, Batch rhs) {
+    return _mm_movemask_ps(_mm_cmpge_ps(lhs.value, rhs.value));
+  }
+  friend Mask Less(Batch lhs, Batch rhs) {
+    return _mm_movemask_ps(_mm_cmplt_ps(lhs.value, rhs.value));
+  }
+  friend Batch Select(Mask mask, Batch if_set, Batch otherwise) {
+    __m128 lanes = _mm_castsi128_ps(
+        _mm_setr_epi32(-int32_t(mask & 1u), -int32_t(mask >> 1 & 1u),
+                       -int32_t(mask >> 2 & 1u), -int32_t(mask >> 3 & 1u)));
+    return {_mm_or_ps(_mm_and_ps(lanes, if_set.value),
+                      _mm_andnot_ps(lanes, otherwise.value))};
+  }
+
+  __m128 value;
+};
+
+#endif
+
+using ElemBatch = Batch<Linear::ElemType>;
+using ScalarElemBatch = Batch<Linear::ElemType, 1>;
+
+}  // namespace Rendering
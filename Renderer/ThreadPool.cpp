@@ -0,0 +1,109 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include "../Profiling/Trace.h"
+
+namespace Rendering {
+
+ThreadPool::ThreadPool(Index threads_count) {
+  StartWorkers(threads_count);
+}
+
+ThreadPool::~ThreadPool() {
+  StopWorkers();
+}
+
+Linear::Index ThreadPool::GetThreadsCount() const {
+  return workers_.size() + 1;
+}
+
+void ThreadPool::SetThreadsCount(Index threads_count) {
+  assert(threads_count >= 1 && "There is at least the calling thread");
+  if (threads_count == GetThreadsCount()) {
+    return;
+  }
+  StopWorkers();
+  StartWorkers(threads_count);
+}
+
+Linear::Index ThreadPool::GetDefaultThreadsCount() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::StartWorkers(Index threads_count) {
+  // New workers wait for the next batch, not the last finished one
+  for (Index i = 1; i < threads_count; ++i) {
+    workers_.emplace_back(
+        [this, generation = generation_]() { WorkerLoop(generation); });
+  }
+}
+
+void ThreadPool::StopWorkers() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  start_condition_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  stopping_ = false;
+}
+
+void ThreadPool::Run(Index tasks_count, void* context, TaskFunction function) {
+  if (workers_.empty() || tasks_count <= 1) {
+    for (Index i = 0; i < tasks_count; ++i) {
+      function(context, i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard lock(mutex_);
+    function_ = function;
+    context_ = context;
+    tasks_count_ = tasks_count;
+    next_task_ = 0;
+    active_workers_ = workers_.size();
+    ++generation_;
+  }
+  start_condition_.notify_all();
+
+  ExecuteTasks();
+
+  std::unique_lock lock(mutex_);
+  finish_condition_.wait(lock, [this]() { return active_workers_ == 0; });
+}
+
+void ThreadPool::WorkerLoop(unsigned long long seen_generation) {
+  Profiling::SetThreadName("tile worker");
+  while (true) {
+    {
+      std::unique_lock lock(mutex_);
+      start_condition_.wait(lock, [&]() {
+        return stopping_ || generation_ != seen_generation;
+      });
+      if (stopping_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+
+    ExecuteTasks();
+
+    std::lock_guard lock(mutex_);
+    if (--active_workers_ == 0) {
+      finish_condition_.notify_one();
+    }
+  }
+}
+
+void ThreadPool::ExecuteTasks() {
+  for (Index task_index = next_task_.fetch_add(1); task_index < tasks_count_;
+       task_index = next_task_.fetch_add(1)) {
+    function_(context_, task_index);
+  }
+}
+
+}  // namespace Rendering
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../MathUtils/Matrix.h"
+
+namespace Rendering {
+
+class ThreadPool {
+  using Index = Linear::Index;
+  using TaskFunction = void (*)(void* context, Index task_index);
+
+public:
+  explicit ThreadPool(Index threads_count = GetDefaultThreadsCount());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Calls task(i) for every i in [0, tasks_count) and returns once all calls
+  // are finished. The calling thread takes part in the work.
+  template <typename Task>
+  void ParallelFor(Index tasks_count, Task&& task) {
+    using TaskType = std::remove_reference_t<Task>;
+    Run(tasks_count, const_cast<void*>(static_cast<const void*>(&task)),
+        [](void* context, Index task_index) {
+          (*static_cast<TaskType*>(context))(task_index);
+        });
+  }
+
+  Index GetThreadsCount() const;
+  // Restarts the workers, must not be called while ParallelFor runs
+  void SetThreadsCount(Index threads_count);
+
+  static Index GetDefaultThreadsCount();
+
+private:
+  void StartWorkers(Index threads_count);
+  void StopWorkers();
+
+  void Run(Index tasks_count, void* context, TaskFunction function);
+  void WorkerLoop(unsigned long long seen_generation);
+  void ExecuteTasks();
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable start_condition_;
+  std::condition_variable finish_condition_;
+
+  TaskFunction function_ = nullptr;
+  void* context_ = nullptr;
+  Index tasks_count_ = 0;
+  std::atomic<Index> next_task_ = 0;
+
+  unsigned long long generation_ = 0;
+  Index active_workers_ = 0;
+  bool stopping_ = false;
+};
+
+}  // namespace Rendering
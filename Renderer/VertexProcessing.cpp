@@ -0,0 +1,147 @@
+#include "VertexProcessing.h"
+#include "SimdBatch.h"
+
+namespace Rendering {
+
+void TransformedVertices::Resize(Index vertices_count) {
+  Index padded_count = (vertices_count + ElemBatch::kWIDTH - 1) /
+                       ElemBatch::kWIDTH * ElemBatch::kWIDTH;
+  for (Array* array :
+       {&view_positions.x, &view_positions.y, &view_positions.z,
+        &view_normals.x, &view_normals.y, &view_normals.z, &clip_x, &clip_y,
+        &clip_z, &clip_w}) {
+    array->resize(padded_count);
+  }
+}
+
+namespace {
+
+using Matrix4x4Batch = std::array<std::array<ElemBatch, 4>, 4>;
+
+Matrix4x4Batch BroadcastMatrix(const Linear::TransformMatrix4x4& matrix) {
+  Matrix4x4Batch result;
+  for (Linear::Index row = 0; row < 4; ++row) {
+    for (Linear::Index column = 0; column < 4; ++column) {
+      result[row][column] = ElemBatch::Broadcast(matrix(row, column));
+    }
+  }
+  return result;
+}
+
+// Row of the matrix times (x, y, z, w) for a point (w = 1) or a direction
+// (w = 0)
+ElemBatch MultiplyRow(const std::array<ElemBatch, 4>& row, ElemBatch x,
+                      ElemBatch y, ElemBatch z, bool is_point) {
+  ElemBatch result = row[0] * x + row[1] * y + row[2] * z;
+  return is_point ? result + row[3] : result;
+}
+
+// Tolerance of the facing test as the cosine of the angle between the face
+// normal and the direction to the eye, the one of Renderer::IsBackfaceCulled.
+// Faces seen almost edge-on are kept rather than flipping with rounding.
+constexpr Linear::ElemType kFACING_EPS = 1e-6;
+
+// Whether the eye, at signed_distance behind the plane of the triangle, is
+// still within the facing tolerance
+bool IsGrazing(const Scene::Mesh& mesh, Linear::Index triangle_index,
+               const Linear::Point4& eye, Linear::ElemType signed_distance) {
+  Linear::Index vertex_index = mesh.triangles[triangle_index].vertex_indices[0];
+  Linear::ElemType to_eye_x = eye(0) - mesh.positions.x[vertex_index];
+  Linear::ElemType to_eye_y = eye(1) - mesh.positions.y[vertex_index];
+  Linear::ElemType to_eye_z = eye(2) - mesh.positions.z[vertex_index];
+  return signed_distance * signed_distance <=
+         kFACING_EPS * kFACING_EPS *
+             (to_eye_x * to_eye_x + to_eye_y * to_eye_y + to_eye_z * to_eye_z);
+}
+
+}  // namespace
+
+void TransformVertices(const Scene::Mesh& mesh,
+                       const ObjectTransforms& transforms,
+                       TransformedVertices& result) {
+  using Index = Linear::Index;
+
+  Index vertices_count = mesh.GetVerticesCount();
+  result.Resize(vertices_count);
+
+  Matrix4x4Batch model_view = BroadcastMatrix(transforms.model_view);
+  Matrix4x4Batch normal_matrix = BroadcastMatrix(transforms.normal_matrix);
+  Matrix4x4Batch model_view_projection =
+      BroadcastMatrix(transforms.model_view_projection);
+
+  std::array<Linear::ElemType*, 3> view_positions{
+      result.view_positions.x.data(), result.view_positions.y.data(),
+      result.view_positions.z.data()};
+  std::array<Linear::ElemType*, 3> view_normals{
+      result.view_normals.x.data(), result.view_normals.y.data(),
+      result.view_normals.z.data()};
+  std::array<Linear::ElemType*, 4> clip{
+      result.clip_x.data(), result.clip_y.data(), result.clip_z.data(),
+      result.clip_w.data()};
+
+  for (Index i = 0; i < vertices_count; i += ElemBatch::kWIDTH) {
+    Index lanes_count = vertices_count - i;
+    ElemBatch x = ElemBatch::LoadPartial(mesh.positions.x.data() + i,
+                                         lanes_count);
+    ElemBatch y = ElemBatch::LoadPartial(mesh.positions.y.data() + i,
+                                         lanes_count);
+    ElemBatch z = ElemBatch::LoadPartial(mesh.positions.z.data() + i,
+                                         lanes_count);
+    ElemBatch normal_x =
+        ElemBatch::LoadPartial(mesh.normals.x.data() + i, lanes_count);
+    ElemBatch normal_y =
+        ElemBatch::LoadPartial(mesh.normals.y.data() + i, lanes_count);
+    ElemBatch normal_z =
+        ElemBatch::LoadPartial(mesh.normals.z.data() + i, lanes_count);
+
+    for (Index row = 0; row < 3; ++row) {
+      MultiplyRow(model_view[row], x, y, z, true)
+          .Store(view_positions[row] + i);
+      MultiplyRow(normal_matrix[row], normal_x, normal_y, normal_z, false)
+          .Store(view_normals[row] + i);
+    }
+    for (Index row = 0; row < 4; ++row) {
+      MultiplyRow(model_view_projection[row], x, y, z, true)
+          .Store(clip[row] + i);
+    }
+  }
+}
+
+void CollectFrontFacing(const Scene::Mesh& mesh, const Linear::Point4& eye,
+                        std::vector<Linear::Index>& result) {
+  using Index = Linear::Index;
+
+  result.clear();
+  ElemBatch eye_x = ElemBatch::Broadcast(eye(0));
+  ElemBatch eye_y = ElemBatch::Broadcast(eye(1));
+  ElemBatch eye_z = ElemBatch::Broadcast(eye(2));
+
+  // A triangle faces the eye when the eye is on the front side of its plane.
+  // Triangles behind it are checked against the tolerance one by one.
+  std::array<Linear::ElemType, ElemBatch::kWIDTH> eye_distances;
+  Index triangles_count = mesh.GetTrianglesCount();
+  for (Index i = 0; i < triangles_count; i += ElemBatch::kWIDTH) {
+    Index lanes_count = std::min(triangles_count - i, ElemBatch::kWIDTH);
+    ElemBatch distance =
+        ElemBatch::LoadPartial(mesh.face_normals.x.data() + i, lanes_count) *
+            eye_x +
+        ElemBatch::LoadPartial(mesh.face_normals.y.data() + i, lanes_count) *
+            eye_y +
+        ElemBatch::LoadPartial(mesh.face_normals.z.data() + i, lanes_count) *
+            eye_z;
+    ElemBatch::Mask front_facing = GreaterEqual(
+        distance,
+        ElemBatch::LoadPartial(mesh.face_distances.data() + i, lanes_count));
+    distance.Store(eye_distances.data());
+
+    for (Index lane = 0; lane < lanes_count; ++lane) {
+      if ((front_facing & (1u << lane)) ||
+          IsGrazing(mesh, i + lane, eye,
+                    eye_distances[lane] - mesh.face_distances[i + lane])) {
+        result.push_back(i + lane);
+      }
+    }
+  }
+}
+
+}  // namespace Rendering
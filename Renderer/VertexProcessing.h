@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include "../Object/Mesh.h"
+
+namespace Rendering {
+
+// Mesh vertices moved into the camera-relative frame and into clip space,
+// computed once per frame and shared by all triangles using them. Arrays are
+// padded to whole SIMD batches.
+struct TransformedVertices {
+  using Index = Linear::Index;
+  using Array = Scene::Mesh::Array;
+
+  void Resize(Index vertices_count);
+
+  Scene::Mesh::Coordinates view_positions;
+  Scene::Mesh::Coordinates view_normals;
+  Array clip_x;
+  Array clip_y;
+  Array clip_z;
+  Array clip_w;
+};
+
+// Matrices taking one object's mesh into the frame
+struct ObjectTransforms {
+  using TransformMatrix4x4 = Linear::TransformMatrix4x4;
+
+  // Mesh coordinates to the camera-relative frame
+  TransformMatrix4x4 model_view{};
+  // Applied to normals, the rotation part of model_view
+  TransformMatrix4x4 normal_matrix{};
+  // Mesh coordinates to clip space
+  TransformMatrix4x4 model_view_projection{};
+};
+
+// Bulk passes over the structure-of-arrays mesh layout, processing
+// ElemBatch::kWIDTH vertices or triangles at a time.
+
+void TransformVertices(const Scene::Mesh& mesh,
+                       const ObjectTransforms& transforms,
+                       TransformedVertices& result);
+
+// Replaces result with the indices of the triangles whose front side faces
+// eye, given in the mesh's coordinates
+void CollectFrontFacing(const Scene::Mesh& mesh, const Linear::Point4& eye,
+                        std::vector<Linear::Index>& result);
+
+}  // namespace Rendering
@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Profiling/AllocationCounter.h"
+#include "../Profiling/PerfCounters.h"
+#include "../Profiling/Trace.h"
+#include "../Renderer/Renderer.h"
+#include "SceneCorpus.h"
+
+// Renders every scene of the corpus along its scripted path for each
+// combination of thread count and resolution, and writes per-frame latency
+// percentiles and throughput as JSON.
+
+namespace benchmarks {
+
+namespace {
+
+using Index = Linear::Index;
+
+struct Options {
+  std::vector<Index> threads_counts;
+  std::vector<Detail::WindowSize> window_sizes;
+  std::vector<std::string> models;
+  Index warmup_frames = 10;
+  Index frames = 120;
+  std::string output_path;
+  std::string trace_path;
+  bool perf_counters = false;
+};
+
+struct Result {
+  std::string scene;
+  Index triangles_count;
+  Detail::WindowSize window_size;
+  Index threads_count;
+  // Milliseconds, sorted
+  std::vector<double> frame_times{};
+  // Heap allocations made by the renderer during the timed frames
+  uint64_t allocations_count = 0;
+  // Summed over the timed frames, with the frame stats enabled
+  std::array<double, Detail::FrameStats::kSTAGES_COUNT> stage_times{};
+  // Summed like stage_times, when the hardware counters were read
+  bool has_perf_counters = false;
+  std::array<Profiling::PerfCounterValues, Detail::FrameStats::kSTAGES_COUNT>
+      stage_counters{};
+};
+
+std::vector<std::string> Split(const std::string& text, char separator) {
+  std::vector<std::string> result;
+  std::istringstream stream(text);
+  for (std::string part; std::getline(stream, part, separator);) {
+    result.push_back(part);
+  }
+  return result;
+}
+
+// Whole text as a number of at least min_value
+bool ParseIndex(const std::string& text, Index min_value, Index& value) {
+  const char* end = text.data() + text.size();
+  auto [parsed_end, error] = std::from_chars(text.data(), end, value);
+  return error == std::errc() && parsed_end == end && value >= min_value;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "--perf-counters") {
+      options.perf_counters = true;
+      continue;
+    }
+    if (i + 1 == argc) {
+      return false;
+    }
+    std::string value = argv[++i];
+    if (option == "--threads") {
+      options.threads_counts.clear();
+      for (const auto& part : Split(value, ',')) {
+        Index threads_count;
+        if (!ParseIndex(part, 1, threads_count)) {
+          return false;
+        }
+        options.threads_counts.push_back(threads_count);
+      }
+    } else if (option == "--resolutions") {
+      options.window_sizes.clear();
+      for (const auto& part : Split(value, ',')) {
+        std::vector<std::string> sizes = Split(part, 'x');
+        Index width;
+        Index height;
+        if (sizes.size() != 2 || !ParseIndex(sizes[0], 1, width) ||
+            !ParseIndex(sizes[1], 1, height)) {
+          return false;
+        }
+        options.window_sizes.push_back(
+            {Linear::Detail::Height{height}, Linear::Detail::Width{width}});
+      }
+    } else if (option == "--model") {
+      options.models.push_back(value);
+    } else if (option == "--frames") {
+      if (!ParseIndex(value, 1, options.frames)) {
+        return false;
+      }
+    } else if (option == "--warmup") {
+      if (!ParseIndex(value, 0, options.warmup_frames)) {
+        return false;
+      }
+    } else if (option == "--output") {
+      options.output_path = value;
+    } else if (option == "--trace") {
+      options.trace_path = value;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PrintUsage(const char* program_name) {
+  std::cerr << "Usage: " << program_name << " [options]\n"
+            << "  --threads N,N,...          thread counts, 1 to all cores "
+               "in powers of 2 by default\n"
+            << "  --resolutions WxH,WxH,...  640x480,1280x720,1920x1080 by "
+               "default\n"
+            << "  --model FILE               also play an OBJ model\n"
+            << "  --frames N                 timed frames per run, 120 by "
+               "default\n"
+            << "  --warmup N                 untimed frames first, 10 by "
+               "default\n"
+            << "  --output FILE              JSON report, stdout by "
+               "default\n"
+            << "  --trace FILE               Chrome trace of every frame, "
+               "best with a single run\n"
+            << "  --perf-counters            hardware counters per stage, "
+               "Linux only\n";
+}
+
+Result Run(const BenchmarkScene& scene, Detail::WindowSize window_size,
+           Index threads_count, const Options& options) {
+  Rendering::Renderer renderer;
+  renderer.SetThreadsCount(threads_count);
+  renderer.SetPerfCountersEnabled(options.perf_counters);
+  Rendering::RenderTarget target(window_size);
+
+  Result result{.scene = scene.name,
+                .triangles_count = 0,
+                .window_size = window_size,
+                .threads_count = threads_count};
+  for (const auto& object : scene.initial_scene.GetObjects()) {
+    result.triangles_count += object.GetTrianglesCount();
+  }
+
+  // Every run plays the same frames from the same start
+  Scene::SceneSnapshot snapshot = scene.initial_scene;
+  for (Index frame = 0; frame < options.warmup_frames + options.frames;
+       ++frame) {
+    snapshot = scene.step(snapshot, frame);
+    Scene::Camera camera = snapshot.GetCamera();
+
+    Profiling::ScopedAllocationCounter allocations;
+    auto begin = std::chrono::steady_clock::now();
+    renderer.RenderScene(snapshot.GetObjects(), camera, snapshot.GetLights(),
+                         target, &snapshot.GetBVH());
+    auto end = std::chrono::steady_clock::now();
+
+    if (frame >= options.warmup_frames) {
+      result.allocations_count += allocations.GetCount();
+      result.frame_times.push_back(
+          std::chrono::duration<double, std::milli>(end - begin).count());
+      const Detail::FrameStats& stats = renderer.GetFrameStats();
+      result.has_perf_counters = stats.has_perf_counters;
+      for (Index stage = 0; stage < Detail::FrameStats::kSTAGES_COUNT;
+           ++stage) {
+        result.stage_times[stage] += stats.stage_milliseconds[stage];
+        result.stage_counters[stage] += stats.stage_counters[stage];
+      }
+    }
+  }
+  std::sort(result.frame_times.begin(), result.frame_times.end());
+  return result;
+}
+
+// Nearest-rank percentile of sorted values
+double Percentile(const std::vector<double>& values, double percent) {
+  Index rank = std::max<Index>(1, std::ceil(percent / 100 * values.size()));
+  return values[rank - 1];
+}
+
+void WriteReport(std::ostream& out, const std::vector<Result>& results) {
+  out << "{\n"
+      << "  \"elem_type\": \""
+      << (sizeof(Linear::ElemType) == sizeof(float) ? "float" : "double")
+      << "\",\n"
+      << "  \"hardware_threads\": "
+      << Rendering::ThreadPool::GetDefaultThreadsCount() << ",\n"
+      << "  \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& result = results[i];
+    double total_seconds = 0;
+    for (double frame_time : result.frame_times) {
+      total_seconds += frame_time / 1000;
+    }
+    double frames_count = result.frame_times.size();
+    double pixels_count = double(result.window_size.width) *
+                          double(result.window_size.height);
+
+    out << (i == 0 ? "\n" : ",\n") << "    {\"scene\": \"" << result.scene
+        << "\", \"triangles\": " << result.triangles_count
+        << ", \"width\": " << result.window_size.width
+        << ", \"height\": " << result.window_size.height
+        << ", \"threads\": " << result.threads_count
+        << ", \"frames\": " << result.frame_times.size()
+        << ", \"mean_ms\": " << total_seconds * 1000 / frames_count
+        << ", \"p50_ms\": " << Percentile(result.frame_times, 50)
+        << ", \"p95_ms\": " << Percentile(result.frame_times, 95)
+        << ", \"p99_ms\": " << Percentile(result.frame_times, 99)
+        << ", \"triangles_per_second\": "
+        << result.triangles_count * frames_count / total_seconds
+        << ", \"pixels_per_second\": "
+        << pixels_count * frames_count / total_seconds
+        << ", \"allocations_per_frame\": "
+        << result.allocations_count / frames_count;
+    if constexpr (Detail::kFRAME_STATS_ENABLED) {
+      out << ", \"stages_mean_ms\": {";
+      for (Index stage = 0; stage < Detail::FrameStats::kSTAGES_COUNT;
+           ++stage) {
+        out << (stage == 0 ? "" : ", ") << "\""
+            << Detail::FrameStats::kSTAGE_NAMES[stage]
+            << "\": " << result.stage_times[stage] / frames_count;
+      }
+      out << "}";
+    }
+    if (result.has_perf_counters) {
+      using PerfCounterValues = Profiling::PerfCounterValues;
+      out << ", \"stages_mean_counters\": {";
+      for (Index stage = 0; stage < Detail::FrameStats::kSTAGES_COUNT;
+           ++stage) {
+        out << (stage == 0 ? "" : ", ") << "\""
+            << Detail::FrameStats::kSTAGE_NAMES[stage] << "\": {";
+        for (int counter = 0; counter < PerfCounterValues::kCOUNTERS_COUNT;
+             ++counter) {
+          out << (counter == 0 ? "" : ", ") << "\""
+              << PerfCounterValues::kCOUNTER_NAMES[counter] << "\": "
+              << result.stage_counters[stage].counts[counter] / frames_count;
+        }
+        out << "}";
+      }
+      out << "}";
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+}  // namespace benchmarks
+
+int main(int argc, char* argv[]) {
+  using namespace benchmarks;
+
+  Options options;
+  for (Index threads_count = 1;
+       threads_count < Rendering::ThreadPool::GetDefaultThreadsCount();
+       threads_count *= 2) {
+    options.threads_counts.push_back(threads_count);
+  }
+  options.threads_counts.push_back(
+      Rendering::ThreadPool::GetDefaultThreadsCount());
+  options.window_sizes = {
+      {Linear::Detail::Height{480}, Linear::Detail::Width{640}},
+      {Linear::Detail::Height{720}, Linear::Detail::Width{1280}},
+      {Linear::Detail::Height{1080}, Linear::Detail::Width{1920}}};
+  if (!ParseOptions(argc, argv, options)) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<BenchmarkScene> scenes = MakeSceneCorpus();
+  for (const auto& path : options.models) {
+    scenes.push_back(MakeModelScene(path));
+  }
+
+  if (options.perf_counters &&
+      !Profiling::ThreadPerfCounters::Get().IsAvailable()) {
+    std::cerr << "Hardware counters are not available, the report goes "
+                 "without them\n";
+  }
+  if (!options.trace_path.empty()) {
+    Profiling::StartTracing();
+  }
+  std::vector<Result> results;
+  for (const auto& scene : scenes) {
+    for (const auto& window_size : options.window_sizes) {
+      for (Index threads_count : options.threads_counts) {
+        results.push_back(Run(scene, window_size, threads_count, options));
+        const Result& result = results.back();
+        std::cerr << scene.name << " " << window_size.width << "x"
+                  << window_size.height << " threads " << threads_count
+                  << ": p50 " << Percentile(result.frame_times, 50)
+                  << " ms\n";
+      }
+    }
+  }
+
+  if (!options.trace_path.empty()) {
+    Profiling::StopTracing();
+    if (!Profiling::WriteTrace(options.trace_path)) {
+      std::cerr << "Cannot write " << options.trace_path << "\n";
+      return 1;
+    }
+  }
+
+  if (options.output_path.empty()) {
+    WriteReport(std::cout, results);
+    return 0;
+  }
+  std::ofstream out(options.output_path);
+  WriteReport(out, results);
+  return out ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#include "../MathUtils/Plane.h"
+#include "../MathUtils/Point4.h"
+#include "../MathUtils/Triangle.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace benchmarks {
+
+using Linear::Point4;
+using Linear::TransformMatrix4x4;
+
+TEST_CASE("Matrix kernels", "[MathUtils]") {
+  TransformMatrix4x4 rotation = TransformMatrix4x4::MakeRotationX(0.3) *
+                                TransformMatrix4x4::MakeRotationZ(0.7);
+  TransformMatrix4x4 projection = TransformMatrix4x4::Eye() * 2;
+  Point4 point{1, 2, 3, 1};
+
+  BENCHMARK("Matrix 4x4 multiply") {
+    return projection * rotation;
+  };
+
+  BENCHMARK("Transform point") {
+    return Linear::Transform(rotation, point);
+  };
+
+  BENCHMARK("Transpose") {
+    return rotation.Transpose();
+  };
+}
+
+TEST_CASE("Geometry kernels", "[MathUtils]") {
+  Linear::Triangle triangle{{0, 0, 0, 1}, {1, 0.2, 0, 1}, {0.3, 1, 0.5, 1}};
+  Linear::Plane plane({1, 2, 3, 1}, {2, 0, 1, 1}, {0, 1, 4, 1});
+  Point4 point{0.5, -1, 2, 1};
+
+  BENCHMARK("Triangle::GetNormal") {
+    return triangle.GetNormal();
+  };
+
+  BENCHMARK("Plane::GetDistance") {
+    return plane.GetDistance(point);
+  };
+}
+
+}  // namespace benchmarks
@@ -0,0 +1,61 @@
+#include "../Object/Parser.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace benchmarks {
+
+namespace {
+
+// Writes a latitude-longitude sphere with normals and texture coordinates,
+// 2 * rings * segments triangles
+std::filesystem::path WriteSphereObj(int rings, int segments) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "benchmark-sphere.obj";
+  std::ofstream out(path);
+  for (int ring = 0; ring <= rings; ++ring) {
+    double theta = M_PI * ring / rings;
+    for (int segment = 0; segment <= segments; ++segment) {
+      double phi = 2 * M_PI * segment / segments;
+      double x = std::sin(theta) * std::cos(phi);
+      double y = std::sin(theta) * std::sin(phi);
+      double z = std::cos(theta);
+      out << "v " << x << " " << y << " " << z << "\n"
+          << "vn " << x << " " << y << " " << z << "\n"
+          << "vt " << double(segment) / segments << " " << double(ring) / rings
+          << "\n";
+    }
+  }
+  auto corner = [&](int ring, int segment) {
+    int index = ring * (segments + 1) + segment + 1;
+    return std::to_string(index) + "/" + std::to_string(index) + "/" +
+           std::to_string(index);
+  };
+  for (int ring = 0; ring < rings; ++ring) {
+    for (int segment = 0; segment < segments; ++segment) {
+      out << "f " << corner(ring, segment) << " " << corner(ring + 1, segment)
+          << " " << corner(ring + 1, segment + 1) << "\n"
+          << "f " << corner(ring, segment) << " "
+          << corner(ring + 1, segment + 1) << " " << corner(ring, segment + 1)
+          << "\n";
+    }
+  }
+  return path;
+}
+
+}  // namespace
+
+TEST_CASE("OBJ parsing", "[Parser]") {
+  std::filesystem::path path = WriteSphereObj(64, 128);
+
+  BENCHMARK("ObjParser::Parse (16384 triangles)") {
+    return Scene::ObjParser::Parse(path.string());
+  };
+
+  std::filesystem::remove(path);
+}
+
+}  // namespace benchmarks
@@ -0,0 +1,111 @@
+#include "../Renderer/Renderer.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <limits>
+#include <string>
+
+namespace benchmarks {
+
+using Linear::Point4;
+using Linear::Triangle;
+using Scene::TriangleData;
+
+namespace {
+
+Detail::Texture MakeCheckerTexture(int size) {
+  std::vector<Detail::Color> pixels(size * size);
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      pixels[y * size + x] = ((x ^ y) & 8) ? 0xFFFF0000u : 0xFF00FF00u;
+    }
+  }
+  return Detail::Texture(pixels, Linear::Detail::Height{size},
+                         Linear::Detail::Width{size});
+}
+
+// Faces the default camera, which looks down the negative x axis, and
+// covers half of a square window
+TriangleData MakeHalfScreenTriangle() {
+  Point4 normal{1, 0, 0, 0};
+  return {{{-1, 0.95, -0.95, 1}, {-1, -0.95, -0.95, 1}, {-1, 0.95, 0.95, 1}},
+          {normal, normal, normal},
+          {{0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0}},
+          0};
+}
+
+}  // namespace
+
+TEST_CASE("Clipping kernels", "[Renderer]") {
+  Point4 normal{0, 0, 1, 0};
+  TriangleData crossing{{{0, 0, -1, 1}, {1, 0, 1, 1}, {0, 1, 1, 1}},
+                        {normal, normal, normal},
+                        {{0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0}}};
+
+  // Crosses the near plane z = 0 in clip space
+  Rendering::Clipper clipper;
+  Triangle clip_vertices{{0, 0, -0.5, 1}, {0.5, 0, 0.5, 1}, {0, 0.5, 0.5, 1}};
+  Rendering::Clipper::Polygon polygon;
+
+  BENCHMARK("Clipper::Clip") {
+    return clipper.Clip(crossing, clip_vertices, polygon);
+  };
+}
+
+TEST_CASE("Rasterization kernels", "[Renderer]") {
+  Rendering::Renderer renderer;
+  Scene::Camera camera;
+  Detail::Material material;
+  material.texture = MakeCheckerTexture(64);
+  Detail::Lights lights{
+      {Detail::Light::LightType::Point, {}, Point4{10, 10, 10, 1}}};
+  TriangleData triangle = MakeHalfScreenTriangle();
+
+  // The same triangle over windows of growing size. Every run starts from a
+  // cleared depth buffer, which is timed separately for reference.
+  for (int size : {16, 128, 1024}) {
+    Detail::WindowSize window_size{Linear::Detail::Height{size},
+                                   Linear::Detail::Width{size}};
+    renderer.CameraRatioCheck(camera, window_size);
+    Detail::ScreenPicture pixels(size * size);
+    Detail::ZBuffer z_buffer(size * size);
+    std::string suffix = " (" + std::to_string(size * size / 2) + " px)";
+
+    BENCHMARK("Depth buffer clear" + suffix) {
+      std::fill(z_buffer.begin(), z_buffer.end(),
+                std::numeric_limits<Detail::ZDepth>::max());
+      return z_buffer.data();
+    };
+
+    BENCHMARK("RasterizeTriangle" + suffix) {
+      std::fill(z_buffer.begin(), z_buffer.end(),
+                std::numeric_limits<Detail::ZDepth>::max());
+      renderer.RasterizeTriangle(triangle, &material, camera, window_size,
+                                 pixels, z_buffer, lights);
+      return pixels.data();
+    };
+  }
+}
+
+TEST_CASE("Texture sampling", "[Renderer]") {
+  static constexpr int kSAMPLES_COUNT = 1024;
+
+  Detail::Texture texture = MakeCheckerTexture(256);
+  // Scattered coordinates, so that samples do not stay in one cache line
+  std::vector<Linear::Vector4> texture_coords;
+  for (int i = 0; i < kSAMPLES_COUNT; ++i) {
+    texture_coords.push_back({Linear::ElemType(i * 37 % 101) / 101,
+                              Linear::ElemType(i * 61 % 97) / 97, 0, 0});
+  }
+
+  BENCHMARK("Texture::Sample x" + std::to_string(kSAMPLES_COUNT)) {
+    Detail::Color result = 0;
+    for (const auto& texture_coord : texture_coords) {
+      result ^= texture.Sample(texture_coord);
+    }
+    return result;
+  };
+}
+
+}  // namespace benchmarks
@@ -0,0 +1,270 @@
+#include "SceneCorpus.h"
+#include <array>
+#include <cmath>
+#include <memory>
+#include "../Object/Parser.h"
+
+namespace benchmarks {
+
+namespace {
+
+using Index = Linear::Index;
+using ElemType = Linear::ElemType;
+using Point4 = Linear::Point4;
+using TransformMatrix4x4 = Linear::TransformMatrix4x4;
+using Scene::Object;
+using Scene::SceneSnapshot;
+using Scene::TriangleData;
+
+// Deterministic replacement for rand(), the same on every platform
+class Random {
+public:
+  explicit Random(uint32_t seed) : state_(seed) {
+  }
+
+  // Uniform in [begin, end)
+  ElemType Next(ElemType begin, ElemType end) {
+    state_ = state_ * 1664525u + 1013904223u;
+    return begin + (end - begin) * (state_ >> 8) / ElemType(1 << 24);
+  }
+
+private:
+  uint32_t state_;
+};
+
+Detail::Material MakeCheckerMaterial(Detail::Color first,
+                                     Detail::Color second) {
+  static constexpr int kSIZE = 64;
+  std::vector<Detail::Color> pixels(kSIZE * kSIZE);
+  for (int y = 0; y < kSIZE; ++y) {
+    for (int x = 0; x < kSIZE; ++x) {
+      pixels[y * kSIZE + x] = ((x ^ y) & 8) ? first : second;
+    }
+  }
+  Detail::Material material;
+  material.texture = Detail::Texture(pixels, Linear::Detail::Height{kSIZE},
+                                     Linear::Detail::Width{kSIZE});
+  return material;
+}
+
+Scene::MeshAssetPtr MakeAsset(const std::vector<TriangleData>& triangles,
+                              std::vector<Detail::Material>&& materials) {
+  return std::make_shared<const Scene::MeshAsset>(Scene::Mesh::Weld(triangles),
+                                                  std::move(materials));
+}
+
+// Unit sphere facing outwards, 2 * rings * segments triangles
+std::vector<TriangleData> MakeSphere(Index rings, Index segments,
+                                     Index material_index) {
+  auto vertex = [&](Index ring, Index segment) {
+    ElemType theta = M_PI * ring / rings;
+    ElemType phi = 2 * M_PI * segment / segments;
+    return Point4{std::sin(theta) * std::cos(phi),
+                  std::sin(theta) * std::sin(phi), std::cos(theta), 1};
+  };
+  auto texture_coord = [&](Index ring, Index segment) {
+    return Point4{ElemType(segment) / segments, ElemType(ring) / rings, 0, 0};
+  };
+  auto normal = [](const Point4& point) {
+    return Point4{point(0), point(1), point(2), 0};
+  };
+
+  std::vector<TriangleData> result;
+  for (Index ring = 0; ring < rings; ++ring) {
+    for (Index segment = 0; segment < segments; ++segment) {
+      std::array<std::pair<Index, Index>, 4> corners{
+          {{ring, segment},
+           {ring + 1, segment},
+           {ring + 1, segment + 1},
+           {ring, segment + 1}}};
+      for (auto [first, second, third] :
+           {std::array<Index, 3>{0, 1, 2}, std::array<Index, 3>{0, 2, 3}}) {
+        Linear::Triangle positions, normals, texture_coords;
+        Index indices[3] = {first, second, third};
+        for (Index i = 0; i < 3; ++i) {
+          auto [corner_ring, corner_segment] = corners[indices[i]];
+          positions(i) = vertex(corner_ring, corner_segment);
+          normals(i) = normal(positions(i));
+          texture_coords(i) = texture_coord(corner_ring, corner_segment);
+        }
+        result.emplace_back(positions, normals, texture_coords,
+                            material_index);
+      }
+    }
+  }
+  return result;
+}
+
+// Axis-aligned box from (-1, -1, 0) to (1, 1, height) facing outwards
+std::vector<TriangleData> MakeBox(ElemType height, Index material_index) {
+  std::vector<TriangleData> result;
+  auto add_face = [&](Point4 origin, Point4 u, Point4 v) {
+    Point4 normal = Linear::Normalize(Linear::CrossProduct(u, v));
+    Linear::Triangle normals{normal, normal, normal};
+    result.emplace_back(Linear::Triangle{origin, origin + u, origin + u + v},
+                        normals,
+                        Linear::Triangle{{0, 0, 0, 0}, {1, 0, 0, 0},
+                                         {1, 1, 0, 0}},
+                        material_index);
+    result.emplace_back(Linear::Triangle{origin, origin + u + v, origin + v},
+                        normals,
+                        Linear::Triangle{{0, 0, 0, 0}, {1, 1, 0, 0},
+                                         {0, 1, 0, 0}},
+                        material_index);
+  };
+  Point4 x{2, 0, 0, 0};
+  Point4 y{0, 2, 0, 0};
+  Point4 z{0, 0, height, 0};
+  add_face({-1, -1, 0, 1}, y, x);
+  add_face({-1, -1, height, 1}, x, y);
+  add_face({-1, -1, 0, 1}, x, z);
+  add_face({-1, 1, 0, 1}, z, x);
+  add_face({-1, -1, 0, 1}, z, y);
+  add_face({1, -1, 0, 1}, y, z);
+  return result;
+}
+
+Object Place(const Scene::MeshAssetPtr& asset, const Point4& position,
+             ElemType scale = 1) {
+  Object object(asset);
+  object.SetPosition(position);
+  object.SetScale(scale);
+  return object;
+}
+
+// The camera sits at the origin and looks down the negative x axis, like
+// the viewer's initial camera
+SceneSnapshot MakeInitialScene(const std::vector<Object>& objects) {
+  SceneSnapshot result;
+  for (const auto& object : objects) {
+    result = result.WithObjectAdded(object);
+  }
+  return result.WithLightAdded(
+      {Detail::Light::LightType::Point, {}, Point4{10, 10, 10, 1}});
+}
+
+// Counterparts of the Controller slots
+
+SceneSnapshot MoveCamera(const SceneSnapshot& scene, ElemType dx, ElemType dy,
+                         ElemType dz) {
+  Scene::Camera camera = scene.GetCamera();
+  camera.SetPosition(camera.GetPosition() + Point4{dx, dy, dz, 0});
+  return scene.WithCamera(camera);
+}
+
+SceneSnapshot RotateCamera(const SceneSnapshot& scene, ElemType delta_pitch,
+                           ElemType delta_yaw) {
+  Scene::Camera camera = scene.GetCamera();
+  camera.SetPitch(camera.GetPitch() + delta_pitch);
+  camera.SetYAW(camera.GetYAW() + delta_yaw);
+  return scene.WithCamera(camera);
+}
+
+SceneSnapshot MoveObject(const SceneSnapshot& scene, Index index, ElemType dx,
+                         ElemType dy, ElemType dz) {
+  Object object = scene.GetObject(index);
+  object.SetPosition(object.GetPosition() + Point4{dx, dy, dz, 0});
+  return scene.WithObject(index, object);
+}
+
+SceneSnapshot RotateObject(const SceneSnapshot& scene, Index index,
+                           ElemType rx, ElemType ry, ElemType rz) {
+  Object object = scene.GetObject(index);
+  object.Rotate(TransformMatrix4x4::MakeRotationZ(rz) *
+                TransformMatrix4x4::MakeRotationY(ry) *
+                TransformMatrix4x4::MakeRotationX(rx));
+  return scene.WithObject(index, object);
+}
+
+// Walks forward and back while looking around, and keeps a few objects
+// spinning and bobbing
+SceneSnapshot PlayPath(const SceneSnapshot& scene, Index frame_index) {
+  static constexpr Index kPERIOD = 120;
+
+  Index phase = frame_index % kPERIOD;
+  ElemType direction = phase < kPERIOD / 2 ? 1 : -1;
+  SceneSnapshot result = MoveCamera(scene, -0.05 * direction, 0, 0);
+  result = RotateCamera(result, 0.002 * direction,
+                        (phase % (kPERIOD / 2)) < kPERIOD / 4 ? 0.01 : -0.01);
+
+  Index objects_count = result.GetObjectsCount();
+  if (objects_count > 0) {
+    result = RotateObject(result, frame_index % objects_count, 0, 0, 0.05);
+    result = MoveObject(result, (frame_index * 7) % objects_count, 0, 0,
+                        0.02 * direction);
+  }
+  return result;
+}
+
+BenchmarkScene MakeSpheresScene() {
+  std::array<Scene::MeshAssetPtr, 2> spheres{
+      MakeAsset(MakeSphere(16, 32, 0),
+                {MakeCheckerMaterial(0xFFFF0000u, 0xFFFFFF00u)}),
+      MakeAsset(MakeSphere(16, 32, 0),
+                {MakeCheckerMaterial(0xFF0000FFu, 0xFF00FFFFu)})};
+
+  Random random(1);
+  std::vector<Object> objects;
+  for (Index row = 0; row < 8; ++row) {
+    for (Index column = 0; column < 8; ++column) {
+      // Drawn one by one, as the order of function arguments is unspecified
+      ElemType scale = random.Next(0.6, 1.2);
+      ElemType x = -6 - ElemType(3) * row + random.Next(-0.5, 0.5);
+      ElemType y = (ElemType(column) - ElemType(3.5)) * ElemType(2.5) +
+                   random.Next(-0.5, 0.5);
+      ElemType z = random.Next(-1.5, 1.5);
+      objects.push_back(
+          Place(spheres[(row + column) % 2], {x, y, z, 1}, scale));
+    }
+  }
+  return {"spheres", MakeInitialScene(objects), PlayPath};
+}
+
+BenchmarkScene MakeCityScene() {
+  std::vector<Detail::Material> materials{
+      MakeCheckerMaterial(0xFF808080u, 0xFFC0C0C0u),
+      MakeCheckerMaterial(0xFF206020u, 0xFF40A040u)};
+  std::vector<Scene::MeshAssetPtr> buildings;
+  for (ElemType height : {2.0, 4.0, 8.0}) {
+    buildings.push_back(
+        MakeAsset(MakeBox(height, 0), std::vector{materials[0]}));
+  }
+  // 80 by 80 and 0.1 thick once scaled
+  Scene::MeshAssetPtr ground =
+      MakeAsset(MakeBox(0.1 / 40, 0), {materials[1]});
+
+  Random random(2);
+  // The ground is the first object, a large occluder below everything
+  std::vector<Object> objects{Place(ground, {-40, 0, -2.2, 1}, 40)};
+  for (Index row = 0; row < 16; ++row) {
+    for (Index column = 0; column < 16; ++column) {
+      Index kind = Index(random.Next(0, 3));
+      objects.push_back(Place(buildings[kind],
+                              {-5 - ElemType(5) * row,
+                               (ElemType(column) - ElemType(7.5)) * 5, -2.1, 1},
+                              random.Next(0.8, 1.6)));
+    }
+  }
+  return {"city", MakeInitialScene(objects), PlayPath};
+}
+
+BenchmarkScene MakeDenseScene() {
+  Scene::MeshAssetPtr sphere = MakeAsset(
+      MakeSphere(128, 256, 0), {MakeCheckerMaterial(0xFFFFFFFFu, 0xFF000000u)});
+  return {"dense", MakeInitialScene({Place(sphere, {-4, 0, 0, 1}, 2)}),
+          PlayPath};
+}
+
+}  // namespace
+
+std::vector<BenchmarkScene> MakeSceneCorpus() {
+  return {MakeSpheresScene(), MakeCityScene(), MakeDenseScene()};
+}
+
+BenchmarkScene MakeModelScene(const std::string& path) {
+  Object model = Scene::ObjParser::Parse(path);
+  model.SetPosition({-5, 0, 0, 1});
+  return {path, MakeInitialScene({model}), PlayPath};
+}
+
+}  // namespace benchmarks
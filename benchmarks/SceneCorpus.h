@@ -0,0 +1,31 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "../Object/SceneSnapshot.h"
+
+namespace benchmarks {
+
+// Scene of the frame benchmark with the camera and object path played
+// through it. Scenes are generated procedurally, so every build renders
+// exactly the same frames.
+struct BenchmarkScene {
+  using Index = Linear::Index;
+  using SceneSnapshot = Scene::SceneSnapshot;
+
+  std::string name;
+  SceneSnapshot initial_scene;
+  // Edits the scene before frame frame_index with the operations the
+  // viewer's controls perform
+  std::function<SceneSnapshot(const SceneSnapshot&, Index frame_index)> step;
+};
+
+// Grid of textured spheres, a city block of boxes standing on a ground
+// plane, and a single dense mesh filling the view
+std::vector<BenchmarkScene> MakeSceneCorpus();
+
+// An OBJ model in front of the camera, played through the same path
+BenchmarkScene MakeModelScene(const std::string& path);
+
+}  // namespace benchmarks
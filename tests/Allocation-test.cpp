@@ -0,0 +1,66 @@
+#include "../Profiling/AllocationCounter.h"
+#include "../Renderer/Renderer.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace testing {
+
+// Two-sided quads in front of the default camera, which looks down -x
+std::vector<Scene::Object> MakeQuads() {
+  std::vector<Scene::Object> objects;
+  for (Linear::ElemType i = 0; i < 4; ++i) {
+    Linear::Point4 a{-10, -2 + i, -1, 1};
+    Linear::Point4 b{-10, -1 + i, -1, 1};
+    Linear::Point4 c{-10, -1 + i, 1, 1};
+    Linear::Point4 d{-10, -2 + i, 1, 1};
+    Linear::Point4 normal{1, 0, 0, 0};
+    Linear::Triangle normals{normal, normal, normal};
+    std::vector<Scene::TriangleData> triangles{
+        {Linear::Triangle{a, b, c}, normals, {}},
+        {Linear::Triangle{a, c, d}, normals, {}},
+        {Linear::Triangle{a, c, b}, normals, {}},
+        {Linear::Triangle{a, d, c}, normals, {}}};
+    objects.emplace_back(triangles, std::vector<Detail::Material>{});
+  }
+  return objects;
+}
+
+TEST_CASE("Steady-state frame does not allocate", "[Allocation]") {
+  std::vector<Scene::Object> objects = MakeQuads();
+  Scene::BVH bvh;
+  bvh.Build(objects);
+  Detail::Lights lights{{Detail::Light::LightType::Point, {},
+                         Linear::Point4{0, 0, 10, 1}}};
+  Detail::WindowSize window_size{Linear::Detail::Height{120},
+                                 Linear::Detail::Width{160}};
+
+  for (auto mode :
+       {Rendering::ShadingMode::Forward, Rendering::ShadingMode::Deferred}) {
+    Rendering::Renderer renderer;
+    renderer.SetShadingMode(mode);
+    renderer.SetThreadsCount(4);
+    Rendering::RenderTarget target(window_size);
+    Scene::Camera camera;
+
+    // The first frames size the per-frame storage
+    for (int frame = 0; frame < 2; ++frame) {
+      renderer.RenderScene(objects, camera, lights, target, &bvh);
+    }
+
+    Profiling::ScopedAllocationCounter allocations;
+    renderer.RenderScene(objects, camera, lights, target, &bvh);
+    renderer.RenderScene(objects, camera, lights, target);
+    uint64_t allocations_count = allocations.GetCount();
+    REQUIRE(allocations_count == 0);
+
+    Detail::ScreenPicture picture = target.GetPicture();
+    int covered_pixels = 0;
+    for (Detail::Color color : picture) {
+      covered_pixels += color != 0;
+    }
+    REQUIRE(covered_pixels > 0);
+  }
+}
+
+}  // namespace testing
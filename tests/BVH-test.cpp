@@ -0,0 +1,109 @@
+#include "../Object/BVH.h"
+#include "../Object/Camera.h"
+#include "../benchmarks/SceneCorpus.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+
+namespace testing {
+
+using Index = Linear::Index;
+
+// What the hierarchy has to find: every object whose world box is not
+// outside the frustum, with the containment of that box
+std::vector<Scene::VisibleObject> CollectLinearly(
+    const std::vector<Scene::Object>& objects,
+    const Scene::FrustumPlanes& planes) {
+  std::vector<Scene::VisibleObject> result;
+  for (Index index = 0; index < Index(objects.size()); ++index) {
+    Scene::Containment containment =
+        Scene::TestFrustum(planes, objects[index].GetWorldBoundingBox());
+    if (containment != Scene::Containment::Outside) {
+      result.push_back({index, containment});
+    }
+  }
+  return result;
+}
+
+void RequireSameVisible(const std::vector<Scene::Object>& objects,
+                        const Scene::BVH& bvh, std::mt19937& generator) {
+  std::uniform_real_distribution<Linear::ElemType> angles(-3, 3);
+  std::uniform_real_distribution<Linear::ElemType> coords(-20, 20);
+
+  for (int view = 0; view < 100; ++view) {
+    Scene::Camera camera;
+    camera.SetPosition({coords(generator), coords(generator),
+                        coords(generator), 1});
+    camera.SetYAW(angles(generator));
+    camera.SetPitch(angles(generator) / 2);
+    Scene::FrustumPlanes planes =
+        Scene::OffsetFrustum(camera.GetFrustumPlanes(),
+                             camera.GetPosition() - Linear::Point4{0, 0, 0, 1});
+
+    std::vector<Scene::VisibleObject> visible;
+    bvh.CollectVisible(planes, visible);
+    std::vector<Scene::VisibleObject> expected =
+        CollectLinearly(objects, planes);
+
+    REQUIRE(visible.size() == expected.size());
+    for (size_t i = 0; i < visible.size(); ++i) {
+      REQUIRE(visible[i].object_index == expected[i].object_index);
+      REQUIRE(visible[i].containment == expected[i].containment);
+    }
+  }
+}
+
+TEST_CASE("Hierarchy culls like testing every object", "[BVH]") {
+  std::vector<Scene::Object> objects =
+      benchmarks::MakeSceneCorpus()[0].initial_scene.GetObjects();
+  Scene::BVH bvh;
+  bvh.Build(objects);
+  REQUIRE(bvh.GetObjectsCount() == Index(objects.size()));
+
+  std::mt19937 generator(11);
+  RequireSameVisible(objects, bvh, generator);
+
+  SECTION("after objects move and the hierarchy is refitted") {
+    std::uniform_real_distribution<Linear::ElemType> shifts(-5, 5);
+    for (Index index = 0; index < Index(objects.size()); index += 3) {
+      objects[index].SetPosition(
+          objects[index].GetPosition() +
+          Linear::Vector4{shifts(generator), shifts(generator),
+                          shifts(generator), 0});
+      bvh.Refit(objects, index);
+    }
+    RequireSameVisible(objects, bvh, generator);
+  }
+}
+
+TEST_CASE("Inserting objects culls like testing every object", "[BVH]") {
+  std::vector<Scene::Object> corpus_objects =
+      benchmarks::MakeSceneCorpus()[0].initial_scene.GetObjects();
+  std::mt19937 generator(13);
+
+  SECTION("objects of a scene") {
+    std::vector<Scene::Object> objects;
+    Scene::BVH bvh;
+    for (const Scene::Object& object : corpus_objects) {
+      objects.push_back(object);
+      bvh.Insert(objects);
+    }
+    REQUIRE(bvh.GetObjectsCount() == Index(objects.size()));
+    RequireSameVisible(objects, bvh, generator);
+  }
+
+  SECTION("objects along a line, which deepens the tree") {
+    std::vector<Scene::Object> objects;
+    Scene::BVH bvh;
+    for (Index index = 0; index < 500; ++index) {
+      objects.push_back(corpus_objects[0]);
+      objects.back().SetPosition(
+          {Linear::ElemType(index) / 10 - 20, 0, 0, 1});
+      bvh.Insert(objects);
+    }
+    RequireSameVisible(objects, bvh, generator);
+  }
+}
+
+}  // namespace testing
@@ -1,28 +1,154 @@
-#include "../MathUtils/Plane.h"
+#include "../Renderer/Clipper.h"
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
-#include <queue>
+#include <cmath>
 
 namespace testing {
 
-TEST_CASE("Clipping correction", "[Plane]") {
-  Linear::Plane plane =
-      Linear::Plane({0, 0, -2, 0}, {5, 0, 0, 0}, {-10, 10, 0, 0});
-  std::queue<Linear::Triangle> clip_pool;
-  clip_pool.push({{0, 10, 0, 0}, {0, -10, 0, 0}, {0, 0, 20, 0}});
-  plane.ClipThrough(clip_pool);
-
-  REQUIRE(clip_pool.size() == 2);
-  while (!clip_pool.empty()) {
-    auto elem = clip_pool.front();
-    clip_pool.pop();
-    for (int vertex = 0; vertex < 3; ++vertex) {
-      for (int coord = 0; coord < 3; ++coord) {
-        std::cout << elem(vertex)(coord) << " ";
-      }
-      std::cout << "\n";
+using Index = Linear::Index;
+using Linear::Point4;
+using Linear::Triangle;
+using Rendering::Clipper;
+
+constexpr Linear::ElemType kEPS = 1e-5;
+
+// Attributes that are affine in the clip position, so interpolating them
+// along an edge must give the attributes of the interpolated position
+Point4 GetPosition(const Point4& clip_position) {
+  return clip_position;
+}
+
+Point4 GetNormal(const Point4& clip_position) {
+  return {clip_position(2), clip_position(0), clip_position(1) + 1, 0};
+}
+
+Point4 GetTextureCoord(const Point4& clip_position) {
+  return {clip_position(0) + clip_position(1), 2 * clip_position(2), 0, 0};
+}
+
+Scene::TriangleData MakeTriangle(const Triangle& clip_vertices) {
+  auto map = [&](auto attribute) {
+    return Triangle{attribute(clip_vertices(0)), attribute(clip_vertices(1)),
+                    attribute(clip_vertices(2))};
+  };
+  return {map(GetPosition), map(GetNormal), map(GetTextureCoord)};
+}
+
+bool AreClose(const Point4& lhs, const Point4& rhs) {
+  for (Index i = 0; i < 4; ++i) {
+    if (std::abs(lhs(i) - rhs(i)) > kEPS) {
+      return false;
     }
-    std::cout << "\n";
   }
+  return true;
+}
+
+// Every vertex inside the plane, attributes following the clip position and
+// the polygon convex in the xy plane of its (here constant) w
+void RequireClippedPolygon(const Clipper::Polygon& polygon,
+                           auto distance_to_plane) {
+  REQUIRE(polygon.size >= 3);
+  REQUIRE(polygon.size <= Clipper::kMAX_POLYGON_SIZE);
+
+  Linear::ElemType turn_sign = 0;
+  for (Index i = 0; i < polygon.size; ++i) {
+    const Clipper::Vertex& vertex = polygon.vertices[i];
+    REQUIRE(distance_to_plane(vertex.clip_position) >= -kEPS);
+    REQUIRE(AreClose(vertex.position, GetPosition(vertex.clip_position)));
+    REQUIRE(AreClose(vertex.normal, GetNormal(vertex.clip_position)));
+    REQUIRE(AreClose(vertex.texture_coord,
+                     GetTextureCoord(vertex.clip_position)));
+
+    const Point4& a = vertex.clip_position;
+    const Point4& b = polygon.vertices[(i + 1) % polygon.size].clip_position;
+    const Point4& c = polygon.vertices[(i + 2) % polygon.size].clip_position;
+    Linear::ElemType turn =
+        (b(0) - a(0)) * (c(1) - b(1)) - (b(1) - a(1)) * (c(0) - b(0));
+    if (std::abs(turn) > kEPS) {
+      REQUIRE(turn * turn_sign >= 0);
+      turn_sign = turn;
+    }
+  }
+}
+
+TEST_CASE("Clipper keeps triangles inside the view volume", "[Clipper]") {
+  Clipper clipper;
+  Triangle clip_vertices{{0, 0, 0.5, 1}, {0.5, 0, 0.5, 1}, {0, 0.5, 0.2, 1}};
+  Clipper::Polygon polygon;
+
+  REQUIRE(clipper.Classify(clip_vertices) == Clipper::ClipResult::Inside);
+  REQUIRE(clipper.Clip(MakeTriangle(clip_vertices), clip_vertices, polygon) ==
+          Clipper::ClipResult::Inside);
+  REQUIRE(polygon.size == 0);
 }
+
+TEST_CASE("Clipper drops triangles behind one plane", "[Clipper]") {
+  Clipper clipper;
+  Clipper::Polygon polygon;
+
+  SECTION("a side plane") {
+    Triangle clip_vertices{{2, 0, 0.5, 1}, {3, 0, 0.5, 1}, {2, 1, 0.5, 1}};
+    REQUIRE(clipper.Classify(clip_vertices) == Clipper::ClipResult::Outside);
+    REQUIRE(clipper.Clip(MakeTriangle(clip_vertices), clip_vertices,
+                         polygon) == Clipper::ClipResult::Outside);
+  }
+
+  SECTION("the near plane") {
+    Triangle clip_vertices{{0, 0, -0.5, 1}, {1, 0, -0.1, 1}, {0, 1, -2, 1}};
+    REQUIRE(clipper.Classify(clip_vertices) == Clipper::ClipResult::Outside);
+  }
+}
+
+TEST_CASE("Clipper leaves side planes inside the guard band to the raster",
+          "[Clipper]") {
+  Clipper clipper;
+  // Crosses the right and top planes but stays within kGUARD_BAND
+  Triangle clip_vertices{{0, 0, 0.5, 1}, {3, 0, 0.5, 1}, {0, 3, 0.5, 1}};
+  Clipper::Polygon polygon;
+
+  REQUIRE(clipper.Classify(clip_vertices) == Clipper::ClipResult::Inside);
+  REQUIRE(clipper.Clip(MakeTriangle(clip_vertices), clip_vertices, polygon) ==
+          Clipper::ClipResult::Inside);
+  REQUIRE(polygon.size == 0);
+}
+
+TEST_CASE("Clipper cuts triangles crossing the near plane or the guard band",
+          "[Clipper]") {
+  Clipper clipper;
+  Clipper::Polygon polygon;
+
+  SECTION("the near plane") {
+    Triangle clip_vertices{{0, 0, -0.5, 1}, {0.5, 0, 0.5, 1},
+                           {0, 0.5, 0.5, 1}};
+    REQUIRE(clipper.Classify(clip_vertices) == Clipper::ClipResult::Clipped);
+    REQUIRE(clipper.Clip(MakeTriangle(clip_vertices), clip_vertices,
+                         polygon) == Clipper::ClipResult::Clipped);
+    // One vertex cut off turns the triangle into a quad
+    REQUIRE(polygon.size == 4);
+    RequireClippedPolygon(polygon, [](const Point4& p) { return p(2); });
+  }
+
+  SECTION("the guard band") {
+    Linear::ElemType guard_band = Clipper::kGUARD_BAND;
+    Triangle clip_vertices{{0, 0, 0.5, 1}, {10, 1, 0.5, 1}, {0, 1, 0.5, 1}};
+    REQUIRE(clipper.Classify(clip_vertices) == Clipper::ClipResult::Clipped);
+    REQUIRE(clipper.Clip(MakeTriangle(clip_vertices), clip_vertices,
+                         polygon) == Clipper::ClipResult::Clipped);
+    RequireClippedPolygon(polygon, [guard_band](const Point4& p) {
+      return guard_band * p(3) - p(0);
+    });
+  }
+
+  SECTION("both") {
+    Triangle clip_vertices{{-10, 0, 0.5, 1}, {1, 0, -1, 1}, {0, 1, 0.5, 1}};
+    REQUIRE(clipper.Clip(MakeTriangle(clip_vertices), clip_vertices,
+                         polygon) == Clipper::ClipResult::Clipped);
+    Linear::ElemType guard_band = Clipper::kGUARD_BAND;
+    RequireClippedPolygon(polygon, [guard_band](const Point4& p) {
+      return std::min(p(2), p(0) + guard_band * p(3));
+    });
+  }
+}
+
 }  // namespace testing
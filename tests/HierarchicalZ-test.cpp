@@ -0,0 +1,68 @@
+#include "../Renderer/HierarchicalZ.h"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+namespace testing {
+
+using Index = Linear::Index;
+
+TEST_CASE("Pyramid depth bounds the depth buffer", "[HierarchicalZ]") {
+  // Not a multiple of the block size, so the last blocks are partial
+  Detail::WindowSize window_size{Linear::Detail::Height{70},
+                                 Linear::Detail::Width{100}};
+  Index width = window_size.width;
+  Index height = window_size.height;
+  Detail::ZBuffer z_buffer(width * height, 1);
+
+  Rendering::HierarchicalZ hierarchical_z;
+  hierarchical_z.Reset(window_size, 64, 1);
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<Linear::ElemType> depths(0, 1);
+  std::uniform_int_distribution<Index> xs(0, width - 1);
+  std::uniform_int_distribution<Index> ys(0, height - 1);
+  constexpr Index kBLOCK_SIZE = Rendering::HierarchicalZ::kBLOCK_SIZE;
+
+  for (int round = 0; round < 20; ++round) {
+    // Depth only ever decreases, like under the depth test
+    for (int write = 0; write < 200; ++write) {
+      Index x = xs(generator);
+      Index y = ys(generator);
+      Detail::ZDepth& depth = z_buffer[y * width + x];
+      depth = std::min(depth, depths(generator));
+      hierarchical_z.UpdateBlock(z_buffer, x / kBLOCK_SIZE, y / kBLOCK_SIZE);
+    }
+
+    for (int query = 0; query < 200; ++query) {
+      auto [begin_x, end_x] = std::minmax({xs(generator), xs(generator)});
+      auto [begin_y, end_y] = std::minmax({ys(generator), ys(generator)});
+      Detail::ZDepth max_depth = 0;
+      for (Index y = begin_y; y <= end_y; ++y) {
+        for (Index x = begin_x; x <= end_x; ++x) {
+          max_depth = std::max(max_depth, z_buffer[y * width + x]);
+        }
+      }
+      REQUIRE(hierarchical_z.GetMaxDepth(begin_x, begin_y, end_x, end_y) >=
+              max_depth);
+    }
+  }
+}
+
+TEST_CASE("Cleared pyramid reports the clear depth", "[HierarchicalZ]") {
+  Detail::WindowSize window_size{Linear::Detail::Height{64},
+                                 Linear::Detail::Width{128}};
+  Detail::ZBuffer z_buffer(128 * 64, 0.5);
+
+  Rendering::HierarchicalZ hierarchical_z;
+  hierarchical_z.Reset(window_size, 64, 1);
+  hierarchical_z.UpdateBlock(z_buffer, 0, 0);
+  REQUIRE(hierarchical_z.GetMaxDepth(0, 0, 7, 7) == 0.5);
+
+  hierarchical_z.Clear(0, 0, 63, 63, 1);
+  REQUIRE(hierarchical_z.GetMaxDepth(0, 0, 7, 7) == 1);
+  REQUIRE(hierarchical_z.GetMaxDepth(0, 0, 127, 63) == 1);
+}
+
+}  // namespace testing
@@ -0,0 +1,76 @@
+#include "../Object/Mesh.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+namespace testing {
+
+using Index = Linear::Index;
+using Point4 = Linear::Point4;
+
+const Linear::Triangle kNORMALS{{0, 0, 1, 0}, {0, 0, 1, 0}, {0, 0, 1, 0}};
+const Linear::Triangle kTEXTURE_COORDS{{0, 0, 0, 0}, {1, 0, 0, 0},
+                                       {0, 1, 0, 0}};
+
+void RequireSameTriangle(const Scene::TriangleData& lhs,
+                         const Scene::TriangleData& rhs) {
+  for (Index i = 0; i < 3; ++i) {
+    REQUIRE(lhs.vertices(i) == rhs.vertices(i));
+    REQUIRE(lhs.normals(i) == rhs.normals(i));
+    REQUIRE(lhs.texture_coords(i) == rhs.texture_coords(i));
+  }
+  REQUIRE(lhs.material_index == rhs.material_index);
+}
+
+TEST_CASE("Welding merges only equal corners", "[Mesh]") {
+  // Two triangles of a quad sharing the diagonal from (1, 0) to (0, 1)
+  std::vector<Scene::TriangleData> triangles{
+      {{{0, 0, 0, 1}, {1, 0, 0, 1}, {0, 1, 0, 1}}, kNORMALS, kTEXTURE_COORDS,
+       0},
+      {{{1, 1, 0, 1}, {0, 1, 0, 1}, {1, 0, 0, 1}},
+       kNORMALS,
+       {{0, 0, 0, 0}, {0, 1, 0, 0}, {1, 0, 0, 0}},
+       1}};
+
+  SECTION("corners with equal attributes are stored once") {
+    Scene::Mesh mesh = Scene::Mesh::Weld(triangles);
+    REQUIRE(mesh.GetTrianglesCount() == 2);
+    REQUIRE(mesh.GetVerticesCount() == 4);
+    REQUIRE(mesh.triangles[1].vertex_indices[1] ==
+            mesh.triangles[0].vertex_indices[2]);
+    REQUIRE(mesh.triangles[1].vertex_indices[2] ==
+            mesh.triangles[0].vertex_indices[1]);
+    for (Index index = 0; index < 2; ++index) {
+      RequireSameTriangle(mesh.GetTriangle(index), triangles[index]);
+    }
+  }
+
+  SECTION("corners differing in any attribute stay apart") {
+    triangles[1].normals = {{0, 0, -1, 0}, {0, 0, 1, 0}, {0, 0, 1, 0}};
+    triangles[1].texture_coords = {{0, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 0, 0}};
+    Scene::Mesh mesh = Scene::Mesh::Weld(triangles);
+    REQUIRE(mesh.GetVerticesCount() == 5);
+    for (Index index = 0; index < 2; ++index) {
+      RequireSameTriangle(mesh.GetTriangle(index), triangles[index]);
+    }
+  }
+}
+
+TEST_CASE("Face planes contain their triangles", "[Mesh]") {
+  std::vector<Scene::TriangleData> triangles{
+      {{{1, 0, 2, 1}, {0, 3, 1, 1}, {-1, -1, 0, 1}}, kNORMALS,
+       kTEXTURE_COORDS}};
+  Scene::Mesh mesh = Scene::Mesh::Weld(triangles);
+  REQUIRE(mesh.face_distances.size() == 1);
+
+  Point4 normal{mesh.face_normals.x[0], mesh.face_normals.y[0],
+                mesh.face_normals.z[0], 0};
+  for (Index i = 0; i < 3; ++i) {
+    Linear::ElemType distance =
+        Linear::DotProduct(normal, triangles[0].vertices(i));
+    REQUIRE(std::abs(distance - mesh.face_distances[0]) < 1e-4);
+  }
+}
+
+}  // namespace testing
@@ -0,0 +1,38 @@
+#include "../Core/RenderWorker.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <vector>
+
+namespace testing {
+
+// Occupies the worker until the returned promise is set
+std::promise<void> BlockWorker(Core::RenderWorker& worker) {
+  std::promise<void> release;
+  std::promise<void> started;
+  worker.Submit([&started, blocked = release.get_future().share()]() {
+    started.set_value();
+    blocked.wait();
+  });
+  started.get_future().wait();
+  return release;
+}
+
+TEST_CASE("Only the latest pending job runs", "[RenderWorker]") {
+  Core::RenderWorker worker;
+  std::vector<int> ran;
+
+  std::promise<void> release = BlockWorker(worker);
+  for (int job = 0; job < 5; ++job) {
+    worker.Submit([&ran, job]() { ran.push_back(job); });
+  }
+  release.set_value();
+  worker.WaitIdle();
+  REQUIRE(ran == std::vector<int>{4});
+
+  worker.Submit([&ran]() { ran.push_back(5); });
+  worker.WaitIdle();
+  REQUIRE(ran == std::vector<int>{4, 5});
+}
+
+}  // namespace testing
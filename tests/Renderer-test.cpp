@@ -0,0 +1,150 @@
+#include "../Renderer/Renderer.h"
+#include "../benchmarks/SceneCorpus.h"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+namespace testing {
+
+using Index = Linear::Index;
+using Pictures = std::vector<Detail::ScreenPicture>;
+
+const Detail::WindowSize kWINDOW_SIZE{Linear::Detail::Height{90},
+                                      Linear::Detail::Width{160}};
+constexpr Index kFRAMES = 60;
+constexpr Index kFRAMES_STRIDE = 10;
+
+// Every tenth frame of the corpus scenes, rendered by a renderer set up by
+// configure
+Pictures RenderCorpus(
+    const std::function<void(Rendering::Renderer&)>& configure) {
+  Pictures pictures;
+  for (const auto& scene : benchmarks::MakeSceneCorpus()) {
+    Rendering::Renderer renderer;
+    configure(renderer);
+    Rendering::RenderTarget target(kWINDOW_SIZE);
+
+    Scene::SceneSnapshot snapshot = scene.initial_scene;
+    for (Index frame = 0; frame < kFRAMES; ++frame) {
+      snapshot = scene.step(snapshot, frame);
+      if (frame % kFRAMES_STRIDE != 0) {
+        continue;
+      }
+      Scene::Camera camera = snapshot.GetCamera();
+      renderer.RenderScene(snapshot.GetObjects(), camera,
+                           snapshot.GetLights(), target, &snapshot.GetBVH());
+      pictures.push_back(target.GetPicture());
+    }
+  }
+  return pictures;
+}
+
+// Pixels covered by geometry
+Index CountCovered(const Detail::ScreenPicture& picture) {
+  Index result = 0;
+  for (Detail::Color color : picture) {
+    result += color != Rendering::RenderTarget::kCLEAR_COLOR;
+  }
+  return result;
+}
+
+TEST_CASE("Float and double builds cover the same pixels", "[Renderer]") {
+  // Covered pixels of every picture of RenderCorpus, recorded from the
+  // double build, which is the reference for the float one
+  constexpr std::array<Index, 18> kREFERENCE_COVERED{
+      2115,  2264,  2426,  2744,  3286,  4021,  12937, 12882, 13137,
+      13503, 13593, 13642, 2256,  3402,  5674,  8048,  9672,  0};
+
+  Pictures pictures = RenderCorpus([](Rendering::Renderer&) {});
+
+  REQUIRE(pictures.size() == kREFERENCE_COVERED.size());
+  for (size_t i = 0; i < pictures.size(); ++i) {
+    // Rounding may move a few pixels along the silhouettes
+    REQUIRE(std::abs(CountCovered(pictures[i]) - kREFERENCE_COVERED[i]) <=
+            kREFERENCE_COVERED[i] / 100);
+  }
+}
+
+TEST_CASE("Tiles rendered in parallel match a single thread",
+          "[Renderer]") {
+  Pictures single = RenderCorpus(
+      [](Rendering::Renderer& renderer) { renderer.SetThreadsCount(1); });
+  Pictures parallel = RenderCorpus(
+      [](Rendering::Renderer& renderer) { renderer.SetThreadsCount(8); });
+
+  REQUIRE(single.size() == parallel.size());
+  for (size_t i = 0; i < single.size(); ++i) {
+    REQUIRE(single[i] == parallel[i]);
+  }
+}
+
+TEST_CASE("SIMD and scalar kernels render identical images", "[Renderer]") {
+  Pictures simd = RenderCorpus([](Rendering::Renderer&) {});
+  Pictures scalar = RenderCorpus(
+      [](Rendering::Renderer& renderer) { renderer.SetSimdEnabled(false); });
+
+  REQUIRE(simd.size() == scalar.size());
+  for (size_t i = 0; i < simd.size(); ++i) {
+    REQUIRE(simd[i] == scalar[i]);
+  }
+}
+
+TEST_CASE("Deferred and forward shading render identical images",
+          "[Renderer]") {
+  Pictures forward = RenderCorpus([](Rendering::Renderer&) {});
+  Pictures deferred = RenderCorpus([](Rendering::Renderer& renderer) {
+    renderer.SetShadingMode(Rendering::ShadingMode::Deferred);
+  });
+
+  REQUIRE(forward.size() == deferred.size());
+  for (size_t i = 0; i < forward.size(); ++i) {
+    REQUIRE(forward[i] == deferred[i]);
+  }
+}
+
+TEST_CASE("Occlusion culling does not change the image", "[Renderer]") {
+  Pictures culled = RenderCorpus([](Rendering::Renderer&) {});
+  Pictures unculled = RenderCorpus([](Rendering::Renderer& renderer) {
+    renderer.SetOcclusionCullingEnabled(false);
+  });
+
+  REQUIRE(culled.size() == unculled.size());
+  for (size_t i = 0; i < culled.size(); ++i) {
+    REQUIRE(culled[i] == unculled[i]);
+  }
+}
+
+TEST_CASE("Alternating color buffers render like an owned one",
+          "[Renderer]") {
+  Pictures owned = RenderCorpus([](Rendering::Renderer&) {});
+
+  // Three buffers in turn, like a viewer presenting frames
+  Index pixels_count = Index{kWINDOW_SIZE.width} * kWINDOW_SIZE.height;
+  std::array<Detail::ScreenPicture, 3> buffers;
+  buffers.fill(Detail::ScreenPicture(pixels_count));
+  Index picture_index = 0;
+  for (const auto& scene : benchmarks::MakeSceneCorpus()) {
+    Rendering::Renderer renderer;
+    Rendering::RenderTarget target;
+
+    Scene::SceneSnapshot snapshot = scene.initial_scene;
+    for (Index frame = 0; frame < kFRAMES; ++frame) {
+      snapshot = scene.step(snapshot, frame);
+      if (frame % kFRAMES_STRIDE != 0) {
+        continue;
+      }
+      Detail::ScreenPicture& buffer = buffers[picture_index % buffers.size()];
+      target.AttachColorBuffer(buffer.data(), kWINDOW_SIZE);
+      Scene::Camera camera = snapshot.GetCamera();
+      renderer.RenderScene(snapshot.GetObjects(), camera,
+                           snapshot.GetLights(), target, &snapshot.GetBVH());
+      REQUIRE(buffer == owned[picture_index]);
+      ++picture_index;
+    }
+  }
+}
+
+}  // namespace testing
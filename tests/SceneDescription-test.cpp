@@ -0,0 +1,117 @@
+#include "../Headless/SceneDescription.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace testing {
+
+// Scene file with the given text in a directory of its own
+std::string WriteSceneFile(const std::string& name, const std::string& text) {
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "scene-description-test";
+  std::filesystem::create_directories(directory);
+  std::filesystem::path path = directory / name;
+  std::ofstream(path) << text;
+  return path.string();
+}
+
+std::string GetDirectory(const std::string& path) {
+  return path.substr(0, path.find_last_of('/') + 1);
+}
+
+bool ParseArguments(std::vector<std::string> arguments,
+                    Headless::SceneDescription& description) {
+  arguments.insert(arguments.begin(), "headless");
+  std::vector<char*> argv;
+  for (std::string& argument : arguments) {
+    argv.push_back(argument.data());
+  }
+  return Headless::ParseCommandLine(argv.size(), argv.data(), description);
+}
+
+TEST_CASE("Scene files are read statement by statement",
+          "[SceneDescription]") {
+  std::string path = WriteSceneFile("scene.txt",
+                                    "# A comment line\n"
+                                    "\n"
+                                    "model cube.obj  # placed at the origin\n"
+                                    "model models/teapot.obj 1 2 -3\n"
+                                    "model /absolute/sphere.obj\n"
+                                    "camera 10 0 5\n"
+                                    "light point 0 0 10\n"
+                                    "resolution 320 200\n"
+                                    "output out.png\n"
+                                    "shading deferred\n");
+  Headless::SceneDescription description;
+  REQUIRE(Headless::ReadSceneFile(path, description));
+
+  std::string directory = GetDirectory(path);
+  REQUIRE(description.models.size() == 3);
+  REQUIRE(description.models[0].path == directory + "cube.obj");
+  REQUIRE(description.models[0].position == Linear::Point4{0, 0, 0, 1});
+  REQUIRE(description.models[1].path == directory + "models/teapot.obj");
+  REQUIRE(description.models[1].position == Linear::Point4{1, 2, -3, 1});
+  REQUIRE(description.models[2].path == "/absolute/sphere.obj");
+
+  REQUIRE(description.camera_position == Linear::Point4{10, 0, 5, 1});
+  REQUIRE(description.lights.size() == 1);
+  REQUIRE(description.lights[0].type == Detail::Light::LightType::Point);
+  REQUIRE(description.lights[0].position == Linear::Point4{0, 0, 10, 1});
+  REQUIRE(description.window_size.width == 320);
+  REQUIRE(description.window_size.height == 200);
+  REQUIRE(description.output_path == "out.png");
+  REQUIRE(description.deferred_shading);
+}
+
+TEST_CASE("Malformed scene statements are rejected", "[SceneDescription]") {
+  for (const char* line :
+       {"model cube.obj 1 2", "camera 1 two 3", "light spot 0 0 1",
+        "resolution 0 200", "shading wireframe", "teleport 1 2 3"}) {
+    std::string path =
+        WriteSceneFile("malformed.txt", std::string("camera 1 2 3\n") + line);
+    Headless::SceneDescription description;
+    REQUIRE_FALSE(Headless::ReadSceneFile(path, description));
+  }
+
+  std::string missing_path =
+      GetDirectory(WriteSceneFile("empty.txt", "")) + "missing.txt";
+  std::filesystem::remove(missing_path);
+  Headless::SceneDescription description;
+  REQUIRE_FALSE(Headless::ReadSceneFile(missing_path, description));
+}
+
+TEST_CASE("Command line options apply on top of scene files",
+          "[SceneDescription]") {
+  std::string path = WriteSceneFile("base.txt",
+                                    "model cube.obj\n"
+                                    "resolution 320 200\n");
+  Headless::SceneDescription description;
+  REQUIRE(ParseArguments({path, "--model", "teapot.obj@1,2,3", "--size",
+                          "64x48", "--camera", "0,1,2", "--deferred"},
+                         description));
+
+  REQUIRE(description.models.size() == 2);
+  REQUIRE(description.models[0].path == GetDirectory(path) + "cube.obj");
+  // Command line paths are taken as given
+  REQUIRE(description.models[1].path == "teapot.obj");
+  REQUIRE(description.models[1].position == Linear::Point4{1, 2, 3, 1});
+  REQUIRE(description.window_size.width == 64);
+  REQUIRE(description.window_size.height == 48);
+  REQUIRE(description.camera_position == Linear::Point4{0, 1, 2, 1});
+  REQUIRE(description.deferred_shading);
+
+  for (std::vector<std::string> arguments :
+       std::vector<std::vector<std::string>>{{"--size", "64by48"},
+                                             {"--camera", "1,2"},
+                                             {"--model", "cube.obj@1,2,x"},
+                                             {"--output"},
+                                             {"--unknown", "1"}}) {
+    Headless::SceneDescription rejected;
+    REQUIRE_FALSE(ParseArguments(arguments, rejected));
+  }
+}
+
+}  // namespace testing
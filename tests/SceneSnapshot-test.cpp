@@ -0,0 +1,88 @@
+#include "../Object/SceneSnapshot.h"
+#include "../benchmarks/SceneCorpus.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace testing {
+
+using Index = Linear::Index;
+
+// Objects visible from the snapshot's camera according to its hierarchy
+std::vector<Scene::VisibleObject> CollectVisible(
+    const Scene::SceneSnapshot& snapshot, const Scene::BVH& bvh) {
+  const Scene::Camera& camera = snapshot.GetCamera();
+  Scene::FrustumPlanes planes =
+      Scene::OffsetFrustum(camera.GetFrustumPlanes(),
+                           camera.GetPosition() - Linear::Point4{0, 0, 0, 1});
+  std::vector<Scene::VisibleObject> result;
+  bvh.CollectVisible(planes, result);
+  return result;
+}
+
+// The snapshot's hierarchy must find what one built from scratch finds
+void RequireHierarchyUpToDate(const Scene::SceneSnapshot& snapshot) {
+  Scene::BVH rebuilt;
+  rebuilt.Build(snapshot.GetObjects());
+  std::vector<Scene::VisibleObject> visible =
+      CollectVisible(snapshot, snapshot.GetBVH());
+  std::vector<Scene::VisibleObject> expected =
+      CollectVisible(snapshot, rebuilt);
+
+  REQUIRE(snapshot.GetBVH().GetObjectsCount() == snapshot.GetObjectsCount());
+  REQUIRE(visible.size() == expected.size());
+  for (size_t i = 0; i < visible.size(); ++i) {
+    REQUIRE(visible[i].object_index == expected[i].object_index);
+    REQUIRE(visible[i].containment == expected[i].containment);
+  }
+}
+
+TEST_CASE("Snapshots share the parts an edit leaves alone",
+          "[SceneSnapshot]") {
+  Scene::SceneSnapshot snapshot =
+      benchmarks::MakeSceneCorpus()[0].initial_scene;
+  REQUIRE(snapshot.GetObjectsCount() > 1);
+
+  SECTION("moving the camera") {
+    Scene::Camera camera = snapshot.GetCamera();
+    camera.SetYAW(1);
+    Scene::SceneSnapshot moved = snapshot.WithCamera(camera);
+    REQUIRE(&moved.GetObjects() == &snapshot.GetObjects());
+    REQUIRE(&moved.GetBVH() == &snapshot.GetBVH());
+    REQUIRE(&moved.GetLights() == &snapshot.GetLights());
+  }
+
+  SECTION("moving an object") {
+    Scene::Object object = snapshot.GetObject(1);
+    Linear::Point4 old_position = object.GetPosition();
+    object.SetPosition(old_position + Linear::Vector4{0, 3, 0, 0});
+    Scene::SceneSnapshot moved = snapshot.WithObject(1, object);
+
+    REQUIRE(&moved.GetLights() == &snapshot.GetLights());
+    for (Index index = 0; index < snapshot.GetObjectsCount(); ++index) {
+      REQUIRE(&moved.GetObject(index).GetMesh() ==
+              &snapshot.GetObject(index).GetMesh());
+    }
+    REQUIRE(snapshot.GetObject(1).GetPosition() == old_position);
+    RequireHierarchyUpToDate(snapshot);
+    RequireHierarchyUpToDate(moved);
+  }
+
+  SECTION("adding objects") {
+    Scene::SceneSnapshot grown = snapshot;
+    for (Index index = 0; index < snapshot.GetObjectsCount(); ++index) {
+      Scene::Object object = snapshot.GetObject(index);
+      object.SetPosition(object.GetPosition() +
+                         Linear::Vector4{1, 0.5, -1, 0});
+      grown = grown.WithObjectAdded(object);
+      RequireHierarchyUpToDate(grown);
+    }
+
+    REQUIRE(grown.GetObjectsCount() == 2 * snapshot.GetObjectsCount());
+    REQUIRE(&grown.GetLights() == &snapshot.GetLights());
+    REQUIRE(&grown.GetObject(0).GetMesh() == &snapshot.GetObject(0).GetMesh());
+    RequireHierarchyUpToDate(snapshot);
+  }
+}
+
+}  // namespace testing